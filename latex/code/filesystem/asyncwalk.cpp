@@ -0,0 +1,99 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <filesystem>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>      // for std::atoi()
+#include "asyncwalk.hpp"
+
+namespace fs = std::filesystem;
+
+// 创建一个有num个文件的树，每个目录最多fanout个条目：
+void createTree(const fs::path& root, int num, int fanout = 100)
+{
+    for (int i = 0; i < num; ++i) {
+        fs::path dir = root;
+        for (int n = i / fanout; n > 0; n /= fanout) {
+            dir /= "d" + std::to_string(n % fanout);
+        }
+        if (i % fanout == 0) {
+            create_directories(dir);
+        }
+        std::ofstream{dir / ("f" + std::to_string(i))} << "file number " << i << '\n';
+    }
+}
+
+// 文件内容的FNV-1a哈希值：
+std::uint64_t hashFile(const fs::path& p)
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    std::ifstream in{p, std::ios::binary};
+    char buf[64 * 1024];
+    while (in.read(buf, sizeof(buf)) || in.gcount() > 0) {
+        for (std::streamsize i = 0; i < in.gcount(); ++i) {
+            h = (h ^ static_cast<unsigned char>(buf[i])) * 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+template<typename F>
+void measure(const char* name, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto [files, sum] = f();
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    std::cout << name << diff.count() << "ms, " << files << " files, hash sum " << sum << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+    fs::path root{argc > 1 ? argv[1] : "tmp/asyncwalk"};
+    int num = argc > 2 ? std::atoi(argv[2]) : 1'000'000;
+    if (!exists(root)) {
+        std::cout << "creating " << num << " files in " << root.string() << '\n';
+        createTree(root, num);
+    }
+
+    // 哈希值的和与顺序无关，所以两种遍历的结果应该相同：
+    measure("recursive_directory_iterator: ", [&] {
+        long files = 0;
+        std::uint64_t sum = 0;
+        for (const auto& e : fs::recursive_directory_iterator{root}) {
+            if (e.is_regular_file()) {
+                ++files;
+                sum += hashFile(e.path());
+            }
+        }
+        return std::pair{files, sum};
+    });
+
+    for (unsigned threads : {1u, 4u, 16u}) {
+        AsyncDirWalk::Options opts;
+        opts.threads = threads;
+        std::string name = "AsyncDirWalk, " + std::to_string(threads) + " threads: ";
+        measure(name.c_str(), [&] {
+            long files = 0;
+            std::uint64_t sum = 0;
+            for (auto& batch : AsyncDirWalk{root, opts}) {
+                for (const auto& e : batch) {
+                    if (e.is_regular_file()) {
+                        ++files;
+                        sum += hashFile(e.path());
+                    }
+                }
+            }
+            return std::pair{files, sum};
+        });
+    }
+
+    // 回调版本：
+    long dirs = 0;
+    auto errors = asyncWalk(root, [&] (const AsyncDirWalk::Batch& batch) {
+        for (const auto& e : batch) {
+            dirs += e.is_directory();
+        }
+    });
+    std::cout << dirs << " directories, " << errors.size() << " errors\n";
+}
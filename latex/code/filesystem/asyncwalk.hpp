@@ -0,0 +1,236 @@
+#ifndef ASYNCWALK_HPP
+#define ASYNCWALK_HPP
+
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <utility>      // for std::pair, std::move()
+#include <iterator>     // for std::input_iterator_tag
+#include <cstddef>      // for std::ptrdiff_t
+
+/********************************************
+* AsyncDirWalk：递归地遍历目录树，但是读取目录的操作由一组工作线程完成，
+* 调用者按批（vector<directory_entry>）获取结果，
+* 所以调用者处理一批条目的同时，工作线程已经在读取其他目录：
+* - next(batch)：类似于生成器，阻塞直到下一批就绪，遍历结束时返回false
+* - begin()/end()：可以用范围for循环逐批遍历
+* - asyncWalk(root, f, opts)：回调版本，对每一批调用f(batch)
+* Options（AsyncWalkOptions）：
+* - threads：同时读取目录的线程数
+* - queueDepth：最多有多少批已经读取但还没有被取走（之后工作线程会等待）
+* - batchSize：每批最多的条目数
+* 错误不会抛出异常，而是记录在errors()中（例如没有权限的目录）
+* 注意：不会跟随指向目录的符号链接（除非指定follow_directory_symlink，
+*      但是此时需要自己保证没有循环）
+* 批之间没有顺序保证
+********************************************/
+
+// 在类外定义，这样可以作为AsyncDirWalk的构造函数的默认参数：
+struct AsyncWalkOptions {
+    unsigned threads = 4;
+    std::size_t queueDepth = 64;
+    std::size_t batchSize = 256;
+    std::filesystem::directory_options dirOptions
+        = std::filesystem::directory_options::skip_permission_denied;
+};
+
+class AsyncDirWalk
+{
+public:
+    using Options = AsyncWalkOptions;
+    using Batch = std::vector<std::filesystem::directory_entry>;
+private:
+    Options opts;
+    std::mutex mx;
+    std::condition_variable workCv;     // 有新的目录或者停止
+    std::condition_variable readyCv;    // 有新的批或者遍历结束
+    std::condition_variable spaceCv;    // 结果队列有空位
+    std::deque<std::filesystem::path> dirs;     // 等待读取的目录
+    std::deque<Batch> ready;                    // 等待被取走的批
+    std::size_t busy = 0;                       // 正在被读取的目录数
+    bool stop = false;
+    std::vector<std::pair<std::filesystem::path, std::error_code>> errs;
+    std::vector<std::thread> workers;
+
+    bool finished() const {     // 调用时必须持有mx
+        return dirs.empty() && busy == 0;
+    }
+
+    void deliver(Batch& batch) {
+        std::unique_lock lk{mx};
+        spaceCv.wait(lk, [this] { return stop || ready.size() < opts.queueDepth; });
+        if (!stop) {
+            ready.push_back(std::move(batch));
+            readyCv.notify_one();
+        }
+        batch.clear();
+    }
+
+    void readDir(const std::filesystem::path& dir) {
+        namespace fs = std::filesystem;
+        bool follow = (opts.dirOptions & fs::directory_options::follow_directory_symlink)
+                      != fs::directory_options::none;
+        Batch batch;
+        batch.reserve(opts.batchSize);
+        std::vector<fs::path> subdirs;
+        std::error_code ec;
+        for (fs::directory_iterator pos{dir, opts.dirOptions, ec}, end; !ec && pos != end;
+             pos.increment(ec)) {
+            const fs::directory_entry& e = *pos;
+            std::error_code ec2;
+            if (e.is_directory(ec2) && (follow || !e.is_symlink(ec2))) {
+                subdirs.push_back(e.path());
+            }
+            batch.push_back(e);
+            if (batch.size() == opts.batchSize) {
+                deliver(batch);
+            }
+        }
+        if (!batch.empty()) {
+            deliver(batch);
+        }
+        std::lock_guard lg{mx};
+        if (ec) {
+            errs.emplace_back(dir, ec);
+        }
+        for (auto& d : subdirs) {
+            dirs.push_back(std::move(d));
+        }
+        if (!subdirs.empty()) {
+            workCv.notify_all();
+        }
+    }
+
+    void workerLoop() {
+        for (;;) {
+            std::filesystem::path dir;
+            {
+                std::unique_lock lk{mx};
+                workCv.wait(lk, [this] { return stop || !dirs.empty() || busy == 0; });
+                if (stop || finished()) {
+                    return;
+                }
+                dir = std::move(dirs.front());
+                dirs.pop_front();
+                ++busy;
+            }
+            readDir(dir);
+            std::lock_guard lg{mx};
+            --busy;
+            if (finished()) {
+                workCv.notify_all();    // 其他工作线程可以结束了
+                readyCv.notify_all();   // 消费者可以结束了
+            }
+        }
+    }
+public:
+    explicit AsyncDirWalk(const std::filesystem::path& root, Options o = {})
+     : opts{o} {
+        if (opts.threads == 0) {
+            opts.threads = 1;
+        }
+        if (opts.queueDepth == 0) {
+            opts.queueDepth = 1;
+        }
+        if (opts.batchSize == 0) {
+            opts.batchSize = 1;
+        }
+        dirs.push_back(root);
+        for (unsigned i = 0; i < opts.threads; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+    // 提前销毁会停止遍历：
+    ~AsyncDirWalk() {
+        {
+            std::lock_guard lg{mx};
+            stop = true;
+        }
+        workCv.notify_all();
+        spaceCv.notify_all();
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+    AsyncDirWalk(const AsyncDirWalk&) = delete;
+    AsyncDirWalk& operator= (const AsyncDirWalk&) = delete;
+
+    // 获取下一批（batch中原来的内容被替换），遍历结束时返回false：
+    bool next(Batch& batch) {
+        std::unique_lock lk{mx};
+        readyCv.wait(lk, [this] { return !ready.empty() || finished(); });
+        if (ready.empty()) {
+            return false;
+        }
+        batch = std::move(ready.front());
+        ready.pop_front();
+        spaceCv.notify_one();
+        return true;
+    }
+
+    // 遍历结束后调用：
+    std::vector<std::pair<std::filesystem::path, std::error_code>> errors() {
+        std::lock_guard lg{mx};
+        return errs;
+    }
+
+    class iterator {
+    private:
+        AsyncDirWalk* walk = nullptr;
+        Batch batch;
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Batch;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Batch*;
+        using reference = Batch&;
+
+        iterator() = default;
+        explicit iterator(AsyncDirWalk* w) : walk{w} {
+            ++*this;
+        }
+        Batch& operator*() {
+            return batch;
+        }
+        Batch* operator->() {
+            return &batch;
+        }
+        iterator& operator++() {
+            if (!walk->next(batch)) {
+                walk = nullptr;
+            }
+            return *this;
+        }
+        bool operator== (const iterator& other) const {
+            return walk == other.walk;
+        }
+        bool operator!= (const iterator& other) const {
+            return walk != other.walk;
+        }
+    };
+
+    iterator begin() {
+        return iterator{this};
+    }
+    iterator end() {
+        return iterator{};
+    }
+};
+
+// 回调版本：在调用者的线程中对每一批调用f
+template<typename F>
+auto asyncWalk(const std::filesystem::path& root, F f, AsyncDirWalk::Options opts = {})
+{
+    AsyncDirWalk walk{root, opts};
+    AsyncDirWalk::Batch batch;
+    while (walk.next(batch)) {
+        f(batch);
+    }
+    return walk.errors();
+}
+
+#endif  // ASYNCWALK_HPP
@@ -0,0 +1,140 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <cstdlib>      // for std::atoi()
+#include "bulkfileops.hpp"
+
+namespace fs = std::filesystem;
+
+template<typename F>
+double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    return diff.count();
+}
+
+std::string smallContent(int i)
+{
+    return "file " + std::to_string(i) + '\n' + std::string(i % 2000, 'a' + i % 26);
+}
+
+fs::path smallPath(const fs::path& dir, int i)
+{
+    return dir / ("d" + std::to_string(i / 100)) / ("f" + std::to_string(i));
+}
+
+std::string readFile(const fs::path& p)
+{
+    std::ifstream in{p, std::ios::binary};
+    std::ostringstream s;
+    s << in.rdbuf();
+    return s.str();
+}
+
+// 比较两个目录树中所有文件的内容：
+bool sameTree(const fs::path& a, const fs::path& b)
+{
+    for (const auto& e : fs::recursive_directory_iterator{a}) {
+        fs::path other = b / e.path().lexically_relative(a);
+        if (e.is_directory() ? !is_directory(other)
+                             : file_size(other) != e.file_size()
+                               || readFile(other) != readFile(e.path())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    // 所有文件都放在root下固定的子目录中，所以只会删除之前运行时创建的文件：
+    fs::path root = fs::path{argc > 1 ? argv[1] : "tmp"} / "bulkfileops-demo";
+    int numSmall = argc > 2 ? std::atoi(argv[2]) : 100'000;
+    int numLarge = argc > 3 ? std::atoi(argv[3]) : 3;
+    long largeMB = argc > 4 ? std::atol(argv[4]) : 2048;
+    bulkops::Options opts;
+    opts.threads = argc > 5 ? std::atoi(argv[5]) : 8;
+    fs::path src = root / "src", dstStd = root / "copy-std", dstBulk = root / "copy-bulk";
+    remove_all(root);
+
+    // 创建小文件：逐个用ofstream，和用BulkFileOps一次创建
+    double t1 = measure([&] {
+        for (int i = 0; i < numSmall; ++i) {
+            fs::path p = smallPath(root / "create-std", i);
+            create_directories(p.parent_path());
+            std::ofstream{p, std::ios::binary} << smallContent(i);
+        }
+    });
+    bulkops::BulkFileOps ops;
+    for (int i = 0; i < numSmall; ++i) {
+        ops.addWrite(smallPath(src / "small", i), smallContent(i));
+    }
+    bulkops::Report report;
+    double t2 = measure([&] {
+        report = ops.run(opts);
+    });
+    std::cout << "create " << numSmall << " small files: ofstream: " << t1 << "ms, BulkFileOps: "
+              << t2 << "ms (" << report.dirsCreated << " dirs, " << report.errors.size()
+              << " errors), " << (sameTree(root / "create-std", src / "small") ? "OK" : "ERROR")
+              << '\n';
+
+    // 大文件：
+    create_directories(src / "large");
+    std::string chunk(1 << 20, 'x');
+    for (int i = 0; i < numLarge; ++i) {
+        std::ofstream out{src / "large" / ("big" + std::to_string(i)), std::ios::binary};
+        for (long mb = 0; mb < largeMB; ++mb) {
+            chunk[0] = static_cast<char>(mb);
+            out.write(chunk.data(), chunk.size());
+        }
+    }
+
+    // 复制整个目录树：std::filesystem::copy()和BulkFileOps
+    t1 = measure([&] {
+        fs::copy(src, dstStd, fs::copy_options::recursive);
+    });
+    t2 = measure([&] {
+        ops.clear();
+        for (const auto& e : fs::recursive_directory_iterator{src}) {
+            fs::path to = dstBulk / e.path().lexically_relative(src);
+            if (e.is_directory()) {
+                ops.addDirectory(to);
+            }
+            else {
+                ops.addCopy(e.path(), to);
+            }
+        }
+        report = ops.run(opts);
+    });
+    std::cout << "copy " << numSmall << " small + " << numLarge << " x " << largeMB
+              << "MB files: std::filesystem::copy(): " << t1 << "ms, BulkFileOps: " << t2
+              << "ms, " << (sameTree(src, dstBulk) ? "OK" : "ERROR") << '\n'
+              << "  " << report.reflinked << " reflinked, " << report.copyFileRange
+              << " with copy_file_range(), " << report.sendfile << " with sendfile(), "
+              << report.readWrite << " with read()/write(), " << report.errors.size()
+              << " errors\n";
+
+    // 出错的操作被逐个报告，其他的操作照常完成：
+    ops.clear();
+    ops.addCopy(src / "missing", root / "errors" / "a");               // 源文件不存在
+    ops.addWrite(root / "errors" / "b", "ok");
+    ops.addWrite(src / "small" / "d0" / "f0" / "c" / "d", "f0 is a file");
+    ops.addWrite(src / "small" / "d0" / "f0" / "c" / "e", "same reason");
+    ops.addWrite(root / "errors" / "f", "ok");
+    fs::path same = smallPath(src / "small", 100);
+    ops.addCopy(same, same.parent_path() / "." / same.filename());    // 复制到自身
+    report = ops.run(opts);
+    for (const auto& e : report.errors) {
+        std::cout << "  operation " << e.index << ": " << e.path.string() << ": "
+                  << e.ec.message() << '\n';
+    }
+    bool ok = report.succeeded == 2 && report.errors.size() == 4
+              && readFile(root / "errors" / "f") == "ok" && readFile(same) == smallContent(100);
+    std::cout << "per-operation errors: " << (ok ? "OK" : "ERROR") << '\n';
+}
@@ -0,0 +1,418 @@
+#ifndef BULKFILEOPS_HPP
+#define BULKFILEOPS_HPP
+
+#include <filesystem>
+#include <system_error>
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <algorithm>    // for std::min(), std::sort()
+#include <iterator>     // for std::distance()
+#include <cstdint>
+#ifdef _MSC_VER
+#include <fstream>
+#else
+#include <cerrno>
+#include <fcntl.h>          // for open(), fallocate()
+#include <unistd.h>         // for read(), write(), close(), copy_file_range()
+#include <sys/stat.h>       // for fstat(), mkdir()
+#include <sys/sendfile.h>   // for sendfile()
+#include <sys/ioctl.h>      // for ioctl()
+#include <linux/fs.h>       // for FICLONE
+#endif
+
+/********************************************
+* BulkFileOps：先收集大量的文件操作，然后由run()用一组线程并行执行：
+* - addDirectory(dir)：创建目录（以及所有的父目录）
+* - addCopy(from, to)：复制文件
+* - addWrite(to, data)：用data创建文件
+* 和逐个调用create_directories()/copy_file()/ofstream相比：
+* - 所有操作需要的父目录先去重，然后按深度一层一层地并行创建，
+*   同一个目录只会调用一次mkdir()
+* - 复制依次尝试：reflink（FICLONE，只复制元数据）、copy_file_range()
+*   （在内核中复制，可能在文件系统内部加速）、sendfile()、read()/write()，
+*   前一种方法不被支持时才使用后一种
+* - 写入和复制之前用fallocate()预先分配空间
+* - 不会因为第一个错误停止：每个失败的操作都记录在返回的Report中
+* Windows上复制和写入使用copy_file()和ofstream
+********************************************/
+
+namespace bulkops {
+
+    struct Options {
+        unsigned threads = 4;
+        bool reflink = true;        // 尝试只复制元数据（写时复制）
+        bool preallocate = true;    // 用fallocate()预先分配空间
+    };
+
+    struct OpError {
+        std::size_t index;              // 第几个操作（按添加的顺序）
+        std::filesystem::path path;     // 出错的路径（源文件、目标或者不能创建的目录）
+        std::error_code ec;
+    };
+
+    struct Report {
+        std::size_t succeeded = 0;
+        std::size_t dirsCreated = 0;    // 新创建的目录数
+        std::size_t reflinked = 0;      // 各种复制方法被使用的次数
+        std::size_t copyFileRange = 0;
+        std::size_t sendfile = 0;
+        std::size_t readWrite = 0;
+        std::vector<OpError> errors;    // 按index排序
+    };
+
+    namespace detail {
+
+        enum class CopyMethod { reflink, copyFileRange, sendfile, readWrite };
+
+#ifndef _MSC_VER
+        inline std::error_code lastError() {
+            return std::error_code{errno, std::generic_category()};
+        }
+
+        // 关闭文件描述符的RAII包装：
+        class Fd {
+        private:
+            int fd;
+        public:
+            explicit Fd(int f) : fd{f} {
+            }
+            Fd(const Fd&) = delete;
+            Fd& operator= (const Fd&) = delete;
+            ~Fd() {
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+            }
+            int get() const {
+                return fd;
+            }
+        };
+
+        inline bool unsupported(int err) {
+            return err == ENOSYS || err == EXDEV || err == EINVAL || err == EOPNOTSUPP
+                   || err == ENOTTY;
+        }
+
+        inline std::error_code writeAll(int fd, const char* p, std::size_t n) {
+            while (n > 0) {
+                auto w = ::write(fd, p, n);
+                if (w < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return lastError();
+                }
+                p += w;
+                n -= static_cast<std::size_t>(w);
+            }
+            return {};
+        }
+
+        inline void preallocate(int fd, std::uint64_t size) {
+            if (size > 0) {
+                ::fallocate(fd, 0, 0, static_cast<off_t>(size));   // 不支持时忽略
+            }
+        }
+
+        inline std::error_code copyFile(const std::filesystem::path& from,
+                                        const std::filesystem::path& to,
+                                        const Options& opts, CopyMethod& method,
+                                        bool& sourceFailed) {
+            Fd in{::open(from.c_str(), O_RDONLY | O_CLOEXEC)};
+            if (in.get() < 0) {
+                sourceFailed = true;
+                return lastError();
+            }
+            struct stat st;
+            if (::fstat(in.get(), &st) != 0) {
+                return lastError();
+            }
+            // 先不截断：目标可能和源文件是同一个文件（相同的路径、别名或者硬链接）
+            Fd out{::open(to.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, st.st_mode & 07777)};
+            if (out.get() < 0) {
+                return lastError();
+            }
+            struct stat outSt;
+            if (::fstat(out.get(), &outSt) != 0) {
+                return lastError();
+            }
+            if (outSt.st_dev == st.st_dev && outSt.st_ino == st.st_ino) {
+                return std::make_error_code(std::errc::file_exists);    // 和copy_file()相同
+            }
+            if (::ftruncate(out.get(), 0) != 0) {
+                return lastError();
+            }
+            auto size = static_cast<std::uint64_t>(st.st_size);
+            if (opts.reflink) {
+                if (::ioctl(out.get(), FICLONE, in.get()) == 0) {
+                    method = CopyMethod::reflink;
+                    return {};
+                }
+                if (!unsupported(errno) && errno != EPERM) {
+                    return lastError();
+                }
+            }
+            if (opts.preallocate) {
+                preallocate(out.get(), size);
+            }
+            std::uint64_t done = 0;
+            method = CopyMethod::copyFileRange;
+            while (done < size) {
+                auto n = ::copy_file_range(in.get(), nullptr, out.get(), nullptr,
+                                           size - done, 0);
+                if (n <= 0) {
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (n < 0 && !unsupported(errno)) {
+                        return lastError();
+                    }
+                    break;      // 不支持（或者文件变短了）：用下一种方法复制剩下的部分
+                }
+                done += static_cast<std::uint64_t>(n);
+            }
+            if (done < size) {
+                method = CopyMethod::sendfile;
+                while (done < size) {
+                    auto n = ::sendfile(out.get(), in.get(), nullptr, size - done);
+                    if (n <= 0) {
+                        if (n < 0 && errno == EINTR) {
+                            continue;
+                        }
+                        if (n < 0 && !unsupported(errno)) {
+                            return lastError();
+                        }
+                        break;
+                    }
+                    done += static_cast<std::uint64_t>(n);
+                }
+            }
+            if (done < size) {
+                method = CopyMethod::readWrite;
+                std::vector<char> buf(1 << 20);
+                for (;;) {
+                    auto n = ::read(in.get(), buf.data(), buf.size());
+                    if (n < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        return lastError();
+                    }
+                    if (n == 0) {
+                        break;
+                    }
+                    if (auto ec = writeAll(out.get(), buf.data(), static_cast<std::size_t>(n))) {
+                        return ec;
+                    }
+                }
+            }
+            // 预先分配的空间比实际写入的多时截断：
+            if (::ftruncate(out.get(), static_cast<off_t>(size)) != 0) {
+                return lastError();
+            }
+            return {};
+        }
+
+        inline std::error_code writeFile(const std::filesystem::path& to, const std::string& data,
+                                         const Options& opts) {
+            Fd out{::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666)};
+            if (out.get() < 0) {
+                return lastError();
+            }
+            if (opts.preallocate) {
+                preallocate(out.get(), data.size());
+            }
+            return writeAll(out.get(), data.data(), data.size());
+        }
+
+        // 已经存在的目录不算错误：
+        inline std::error_code makeDir(const std::filesystem::path& dir, bool& created) {
+            created = ::mkdir(dir.c_str(), 0777) == 0;
+            if (created || errno != EEXIST) {
+                return created ? std::error_code{} : lastError();
+            }
+            struct stat st;
+            if (::stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+                return std::make_error_code(std::errc::not_a_directory);
+            }
+            return {};
+        }
+#else
+        inline std::error_code copyFile(const std::filesystem::path& from,
+                                        const std::filesystem::path& to,
+                                        const Options&, CopyMethod& method,
+                                        bool& sourceFailed) {
+            std::error_code ec;
+            method = CopyMethod::readWrite;
+            sourceFailed = !std::filesystem::exists(from, ec);
+            std::filesystem::copy_file(from, to,
+                                       std::filesystem::copy_options::overwrite_existing, ec);
+            return ec;
+        }
+
+        inline std::error_code writeFile(const std::filesystem::path& to, const std::string& data,
+                                         const Options&) {
+            std::ofstream out{to, std::ios::binary};
+            if (!out.write(data.data(), data.size())) {
+                return std::make_error_code(std::errc::io_error);
+            }
+            return {};
+        }
+
+        inline std::error_code makeDir(const std::filesystem::path& dir, bool& created) {
+            std::error_code ec;
+            created = std::filesystem::create_directory(dir, ec);
+            return ec;
+        }
+#endif
+
+        // 用threads个线程对[0, n)中的每个i调用f(i)：
+        template<typename F>
+        void parallelFor(std::size_t n, unsigned threads, F f) {
+            std::atomic<std::size_t> next{0};
+            auto work = [&] {
+                for (std::size_t i; (i = next.fetch_add(1)) < n; ) {
+                    f(i);
+                }
+            };
+            std::vector<std::thread> workers;
+            for (unsigned t = 1; t < std::min<std::size_t>(threads, n); ++t) {
+                workers.emplace_back(work);
+            }
+            work();
+            for (auto& w : workers) {
+                w.join();
+            }
+        }
+    }
+
+    class BulkFileOps {
+    private:
+        enum class Kind { directory, copy, write };
+        struct Op {
+            Kind kind;
+            std::filesystem::path to;       // 要创建的目录或文件
+            std::filesystem::path from;     // copy
+            std::string data;               // write
+        };
+        std::vector<Op> ops;
+
+        // 操作需要的目录（directory操作是它自己，其他的是父目录）：
+        static std::filesystem::path dirOf(const Op& op) {
+            if (op.kind != Kind::directory) {
+                return op.to.parent_path();
+            }
+            auto dir = op.to.lexically_normal();
+            return dir.has_filename() ? dir : dir.parent_path();    // 去掉末尾的分隔符
+        }
+    public:
+        void addDirectory(std::filesystem::path dir) {
+            ops.push_back(Op{Kind::directory, std::move(dir), {}, {}});
+        }
+        void addCopy(std::filesystem::path from, std::filesystem::path to) {
+            ops.push_back(Op{Kind::copy, std::move(to), std::move(from), {}});
+        }
+        void addWrite(std::filesystem::path to, std::string data) {
+            ops.push_back(Op{Kind::write, std::move(to), {}, std::move(data)});
+        }
+        std::size_t size() const {
+            return ops.size();
+        }
+        void clear() {
+            ops.clear();
+        }
+
+        Report run(const Options& opts = {}) const {
+            namespace fs = std::filesystem;
+            Report report;
+            std::mutex mx;      // 保护report.errors
+            auto fail = [&] (std::size_t index, const fs::path& p, std::error_code ec) {
+                std::lock_guard lg{mx};
+                report.errors.push_back(OpError{index, p, ec});
+            };
+
+            // 第一步：所有需要的目录（去重），按深度分组，一层一层地创建：
+            std::map<std::ptrdiff_t, std::set<fs::path>> levels;
+            std::set<fs::path> seen;
+            for (const auto& op : ops) {
+                for (fs::path dir = dirOf(op);
+                     !dir.empty() && dir != dir.root_path() && dir != "." && seen.insert(dir).second;
+                     dir = dir.parent_path()) {
+                    levels[std::distance(dir.begin(), dir.end())].insert(dir);
+                }
+            }
+            // 失败的目录 -> 失败的原因（自己或者某个祖先目录的错误）：
+            std::map<fs::path, std::pair<fs::path, std::error_code>> failed;
+            std::atomic<std::size_t> dirsCreated{0};
+            for (const auto& [depth, dirs] : levels) {
+                std::vector<const fs::path*> todo;
+                for (const auto& d : dirs) {
+                    todo.push_back(&d);
+                }
+                std::vector<std::pair<fs::path, std::error_code>> errs(todo.size());
+                detail::parallelFor(todo.size(), opts.threads, [&] (std::size_t i) {
+                    const fs::path& d = *todo[i];
+                    if (auto pos = failed.find(d.parent_path()); pos != failed.end()) {
+                        errs[i] = pos->second;
+                        return;
+                    }
+                    bool created = false;
+                    if (auto ec = detail::makeDir(d, created)) {
+                        errs[i] = {d, ec};
+                    }
+                    dirsCreated += created;
+                });
+                for (std::size_t i = 0; i < todo.size(); ++i) {
+                    if (errs[i].second) {
+                        failed.emplace(*todo[i], std::move(errs[i]));
+                    }
+                }
+            }
+            report.dirsCreated = dirsCreated;
+
+            // 第二步：并行地复制和写入文件
+            std::atomic<std::size_t> methods[4] = {};
+            std::atomic<std::size_t> succeeded{0};
+            detail::parallelFor(ops.size(), opts.threads, [&] (std::size_t i) {
+                const Op& op = ops[i];
+                if (auto pos = failed.find(dirOf(op)); pos != failed.end()) {
+                    fail(i, pos->second.first, pos->second.second);
+                    return;
+                }
+                std::error_code ec;
+                bool sourceFailed = false;
+                if (op.kind == Kind::copy) {
+                    detail::CopyMethod method{};
+                    ec = detail::copyFile(op.from, op.to, opts, method, sourceFailed);
+                    if (!ec) {
+                        ++methods[static_cast<int>(method)];
+                    }
+                }
+                else if (op.kind == Kind::write) {
+                    ec = detail::writeFile(op.to, op.data, opts);
+                }
+                if (ec) {
+                    fail(i, sourceFailed ? op.from : op.to, ec);
+                }
+                else {
+                    ++succeeded;
+                }
+            });
+            report.succeeded = succeeded;
+            report.reflinked = methods[0];
+            report.copyFileRange = methods[1];
+            report.sendfile = methods[2];
+            report.readWrite = methods[3];
+            std::sort(report.errors.begin(), report.errors.end(),
+                      [] (const OpError& a, const OpError& b) { return a.index < b.index; });
+            return report;
+        }
+    };
+}
+
+#endif  // BULKFILEOPS_HPP
@@ -0,0 +1,166 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <random>
+#include <filesystem>
+#include <chrono>
+#include <cstdlib>      // for std::atoi()
+#include "canoncache.hpp"
+
+namespace fs = std::filesystem;
+
+// 创建深度为depth的目录链d0/d1/...，每一层中有：
+// - 一个文件f
+// - 符号链接self -> .、up -> ..和top -> 第一层（绝对路径）
+void createTree(const fs::path& root, int depth)
+{
+    fs::path top = fs::absolute(root) / "d0";
+    fs::path dir = top;
+    for (int d = 0; d < depth; ++d) {
+        create_directories(dir);
+        std::ofstream{dir / "f"} << d;
+        create_directory_symlink(".", dir / "self");
+        create_directory_symlink("..", dir / "up");
+        create_directory_symlink(top, dir / "top");
+        dir /= "d" + std::to_string(d + 1);
+    }
+}
+
+// 在目录树中随机游走生成的路径（大部分经过若干个符号链接），以文件f结尾：
+std::vector<std::string> randomPaths(const fs::path& root, int depth, int num, unsigned seed)
+{
+    std::mt19937 eng{seed};
+    std::uniform_int_distribution<int> step{0, 9}, len{1, 3 * depth};
+    std::vector<std::string> paths;
+    paths.reserve(num);
+    for (int i = 0; i < num; ++i) {
+        std::string p = (root / "d0").string();
+        int level = 0;
+        for (int n = len(eng); n > 0; --n) {
+            int s = step(eng);
+            if (s < 6 && level + 1 < depth) {
+                p += "/d" + std::to_string(++level);
+            }
+            else if (s == 6) {
+                p += "/self";
+            }
+            else if (s == 7) {
+                p += "/./";
+            }
+            else if (s == 8 && level > 0) {
+                p += level % 2 ? "/up" : "/..";
+                --level;
+            }
+            else if (s == 9) {
+                p += "/top";
+                level = 0;
+            }
+        }
+        paths.push_back(p + "/f");
+    }
+    return paths;
+}
+
+template<typename F>
+double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    return diff.count();
+}
+
+int main(int argc, char* argv[])
+{
+    fs::path root{argc > 1 ? argv[1] : "tmp/canoncache"};
+    int depth = argc > 2 ? std::atoi(argv[2]) : 30;
+    int num = argc > 3 ? std::atoi(argv[3]) : 200'000;
+    if (!exists(root)) {
+        std::cout << "creating a tree of depth " << depth << " with 3 symlinks per level in "
+                  << root.string() << '\n';
+        createTree(root, depth);
+    }
+    auto paths = randomPaths(root, depth, num, 42);
+
+    std::vector<std::string> expected(paths.size());
+    double t1 = measure([&] {
+        for (std::size_t i = 0; i < paths.size(); ++i) {
+            expected[i] = fs::canonical(paths[i]).string();
+        }
+    });
+    std::cout << num << " x std::filesystem::canonical(): " << t1 << "ms\n";
+
+    // 单线程（第一轮包括填充缓存）：
+    CanonicalCache cache;
+    std::vector<std::string> results(paths.size());
+    for (int round = 0; round < 2; ++round) {
+        double t2 = measure([&] {
+            std::error_code ec;
+            for (std::size_t i = 0; i < paths.size(); ++i) {
+                results[i] = cache.canonical(paths[i], ec);
+            }
+        });
+        std::cout << num << " x CanonicalCache::canonical() (" << (round == 0 ? "cold" : "warm")
+                  << "): " << t2 << "ms, " << (results == expected ? "OK" : "ERROR") << '\n';
+    }
+    std::cout << "  " << cache.hits() << " hits, " << cache.misses() << " misses\n";
+
+    // 多个线程共享同一个缓存：
+    for (unsigned threads : {1u, 4u, 16u}) {
+        cache.flush();
+        std::vector<int> mismatches(threads);
+        double t3 = measure([&] {
+            std::vector<std::thread> workers;
+            for (unsigned t = 0; t < threads; ++t) {
+                workers.emplace_back([&, t] {
+                    std::error_code ec;
+                    for (std::size_t i = t; i < paths.size(); i += threads) {
+                        mismatches[t] += cache.canonical(paths[i], ec) != expected[i];
+                    }
+                });
+            }
+            for (auto& w : workers) {
+                w.join();
+            }
+        });
+        int errors = 0;
+        for (int m : mismatches) {
+            errors += m;
+        }
+        std::cout << threads << " threads, shared cache: " << t3 << "ms, "
+                  << (errors == 0 ? "OK" : "ERROR") << '\n';
+    }
+
+    // mtime检查：修改目录之后缓存的结果会失效
+    CanonicalCache checked{std::chrono::milliseconds{0}};
+    fs::path d0 = root / "d0";
+    std::error_code ec;
+    auto before = checked.canonical((d0 / "moved").string(), ec);
+    bool missing = ec == std::errc::no_such_file_or_directory;
+    create_directory_symlink("d1", d0 / "moved");
+    auto after = checked.canonical((d0 / "moved").string(), ec);
+    bool ok = missing && !ec && after == fs::canonical(d0 / "d1").string();
+    // 文件系统的时间戳精度可能只有几毫秒：
+    std::this_thread::sleep_for(std::chrono::milliseconds{20});
+    remove(d0 / "moved");
+    create_directory_symlink("self", d0 / "moved");
+    after = checked.canonical((d0 / "moved").string(), ec);
+    ok = ok && !ec && after == fs::canonical(d0).string();
+    remove(d0 / "moved");
+    std::cout << "mtime-based invalidation: " << (ok ? "OK" : "ERROR") << '\n';
+
+    // 文件（或者指向文件的符号链接）的后面不能再有任何组件，第一次（慢速路径）和
+    // 第二次（快速路径）都要报告not_a_directory：
+    CanonicalCache fresh;
+    ok = true;
+    for (const char* suffix : {"f/..", "f/.", "f/", "f/x", "self/f/", "self/f/../f"}) {
+        for (int round = 0; round < 2; ++round) {
+            fresh.canonical((d0 / suffix).string(), ec);
+            ok = ok && ec == std::errc::not_a_directory;
+        }
+    }
+    ok = ok && fresh.canonical((d0 / "self/f").string(), ec) == fs::canonical(d0 / "f").string();
+    std::cout << "not a directory: " << (ok ? "OK" : "ERROR") << '\n';
+}
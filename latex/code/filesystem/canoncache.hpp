@@ -0,0 +1,347 @@
+#ifndef CANONCACHE_HPP
+#define CANONCACHE_HPP
+
+#include <filesystem>
+#include <system_error>
+#include <string>
+#include <string_view>
+#include <deque>
+#include <vector>
+#include <memory>           // for std::unique_ptr
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#ifndef _MSC_VER
+#include <cerrno>
+#include <sys/stat.h>       // for lstat(), stat()
+#include <unistd.h>         // for readlink()
+#endif
+
+/********************************************
+* CanonicalCache：和std::filesystem::canonical()相同，但是记住已经解析过的前缀：
+* - 每个已经解析过的目录（规范路径）是一个节点，
+*   节点中记录"名字 -> 解析后的节点"（符号链接已经被解析），
+*   所以同一个目录下的路径只需要在第一次时调用lstat()/readlink()
+* - 完全命中时只在共享锁下沿着指针走一遍，不需要任何系统调用和内存分配
+*   （除了返回的字符串）
+* - 可以并行使用：查找使用共享锁，系统调用在锁外进行，插入时才使用独占锁
+* - 失效：flush()清空所有缓存，invalidate(dir)清空一个目录的缓存；
+*   如果指定了checkInterval，超过这个时间间隔后会检查目录的mtime，
+*   mtime变化时清空该目录的缓存
+* 注意：相对路径会基于调用时的当前路径解析（每次调用需要一次getcwd()）
+*      Windows上直接调用std::filesystem::canonical()（没有缓存）
+********************************************/
+
+class CanonicalCache
+{
+private:
+    struct Node {
+        std::string path;                                   // 规范路径
+        Node* parent;
+        std::deque<std::string> names;                      // links的键指向这里
+        std::unordered_map<std::string_view, Node*> links;  // 名字 -> 解析后的节点
+        std::int64_t mtime = -1;                            // 缓存时目录的mtime
+        std::atomic<std::int64_t> checkedAt{0};             // 上次检查mtime的时间
+        bool isDir = true;      // 不是目录时后面不能再有任何组件（包括.、..和末尾的/）
+    };
+
+    std::chrono::nanoseconds checkInterval;
+    mutable std::shared_mutex mx;
+    std::unordered_map<std::string, std::unique_ptr<Node>> nodes;
+    std::atomic<std::uint64_t> numHits{0};
+    std::atomic<std::uint64_t> numMisses{0};
+    static constexpr int maxLinks = 40;     // 和Linux的ELOOP限制相同
+
+    static std::int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    bool checking() const {
+        return checkInterval != std::chrono::nanoseconds::max();
+    }
+
+    bool fresh(const Node& n) const {
+        return !checking()
+               || nowNs() - n.checkedAt.load(std::memory_order_relaxed) <= checkInterval.count();
+    }
+
+    static std::string parentOf(const std::string& p) {
+        auto pos = p.rfind('/');
+        return pos == 0 || pos == std::string::npos ? "/" : p.substr(0, pos);
+    }
+
+    static std::string joinPath(const std::string& dir, std::string_view name) {
+        std::string r = dir;
+        if (r.back() != '/') {
+            r += '/';
+        }
+        r += name;
+        return r;
+    }
+
+    // 调用时必须持有独占锁：
+    Node* getNode(const std::string& p) {
+        if (auto pos = nodes.find(p); pos != nodes.end()) {
+            return pos->second.get();
+        }
+        Node* parent = p == "/" ? nullptr : getNode(parentOf(p));
+        auto node = std::make_unique<Node>();
+        node->path = p;
+        node->parent = parent ? parent : node.get();    // 根目录的父目录是它自己
+        return nodes.emplace(p, std::move(node)).first->second.get();
+    }
+
+    // 调用时必须持有（共享或独占）锁：
+    Node* findNode(const std::string& p) const {
+        auto pos = nodes.find(p);
+        return pos == nodes.end() ? nullptr : pos->second.get();
+    }
+
+#ifndef _MSC_VER
+    static std::int64_t mtimeOf(const std::string& dir) {
+        struct stat st;
+        if (::stat(dir.c_str(), &st) != 0) {
+            return -1;
+        }
+        return std::int64_t{st.st_mtim.tv_sec} * 1'000'000'000 + st.st_mtim.tv_nsec;
+    }
+
+    // 检查目录的mtime，变化时清空它的缓存：
+    void refresh(const std::string& dir) {
+        auto m = mtimeOf(dir);
+        std::unique_lock lk{mx};
+        Node* n = getNode(dir);
+        if (n->mtime != m) {
+            n->links.clear();
+            n->names.clear();
+            n->mtime = m;
+        }
+        n->checkedAt = nowNs();
+    }
+
+    void addLink(const std::string& dir, std::string_view name, const std::string& target,
+                 bool targetIsDir) {
+        std::unique_lock lk{mx};
+        Node* n = getNode(dir);
+        if (n->links.find(name) == n->links.end()) {
+            Node* t = getNode(target);
+            t->isDir = targetIsDir;
+            n->names.emplace_back(name);
+            n->links.emplace(n->names.back(), t);
+        }
+    }
+
+    // 调用时不能持有锁（没有缓存的路径被当作目录，之后的系统调用会报告错误）：
+    bool isDirectory(const std::string& p) const {
+        std::shared_lock lk{mx};
+        Node* n = findNode(p);
+        return n == nullptr || n->isDir;
+    }
+
+    // 快速路径：只使用缓存，有任何一个组件没有命中时返回false
+    // （非目录的后面还有组件时返回true并设置ec）
+    bool lookup(std::string_view path, std::string& result, std::error_code& ec) const {
+        std::shared_lock lk{mx};
+        Node* cur = findNode("/");
+        if (cur == nullptr) {
+            return false;
+        }
+        std::size_t pos = 0;
+        while (pos < path.size()) {
+            auto end = path.find('/', pos);
+            if (end == std::string_view::npos) {
+                end = path.size();
+            }
+            std::string_view name = path.substr(pos, end - pos);
+            pos = end + 1;
+            if (name.empty() || name == ".") {
+                continue;
+            }
+            if (name == "..") {
+                cur = cur->parent;
+                continue;
+            }
+            if (!fresh(*cur)) {
+                return false;
+            }
+            auto it = cur->links.find(name);
+            if (it == cur->links.end()) {
+                return false;
+            }
+            cur = it->second;
+            if (end < path.size() && !cur->isDir) {
+                ec = std::make_error_code(std::errc::not_a_directory);
+                return true;
+            }
+        }
+        result = cur->path;
+        return true;
+    }
+
+    // 慢速路径：从规范路径base开始解析path，必要时调用系统调用
+    std::string resolve(std::string_view path, std::string base, int& numLinks,
+                        std::error_code& ec) {
+        std::string cur = path.size() > 0 && path[0] == '/' ? "/" : std::move(base);
+        std::size_t pos = 0;
+        while (pos < path.size()) {
+            auto end = path.find('/', pos);
+            if (end == std::string_view::npos) {
+                end = path.size();
+            }
+            std::string_view name = path.substr(pos, end - pos);
+            pos = end + 1;
+            if (name.empty() || name == ".") {
+                continue;
+            }
+            if (name == "..") {
+                cur = parentOf(cur);
+                continue;
+            }
+            // 先查找缓存：
+            bool hit = false;
+            bool hitIsDir = true;
+            for (int attempt = 0; attempt < 2 && !hit; ++attempt) {
+                bool stale = false;
+                {
+                    std::shared_lock lk{mx};
+                    if (Node* n = findNode(cur); n != nullptr) {
+                        if (!fresh(*n)) {
+                            stale = true;
+                        }
+                        else if (auto it = n->links.find(name); it != n->links.end()) {
+                            cur = it->second->path;
+                            hitIsDir = it->second->isDir;
+                            hit = true;
+                        }
+                    }
+                    else {
+                        stale = checking();
+                    }
+                }
+                if (!stale) {
+                    break;
+                }
+                refresh(cur);
+            }
+            if (hit) {
+                numHits.fetch_add(1, std::memory_order_relaxed);
+                if (end < path.size() && !hitIsDir) {
+                    ec = std::make_error_code(std::errc::not_a_directory);
+                    return {};
+                }
+                continue;
+            }
+            numMisses.fetch_add(1, std::memory_order_relaxed);
+            std::string candidate = joinPath(cur, name);
+            struct stat st;
+            if (::lstat(candidate.c_str(), &st) != 0) {
+                ec.assign(errno, std::generic_category());
+                return {};
+            }
+            std::string resolved;
+            bool resolvedIsDir = S_ISDIR(st.st_mode);
+            if (S_ISLNK(st.st_mode)) {
+                if (++numLinks > maxLinks) {
+                    ec = std::make_error_code(std::errc::too_many_symbolic_link_levels);
+                    return {};
+                }
+                std::string target(st.st_size > 0 ? st.st_size : 256, '\0');
+                auto len = ::readlink(candidate.c_str(), target.data(), target.size());
+                if (len < 0) {
+                    ec.assign(errno, std::generic_category());
+                    return {};
+                }
+                target.resize(len);
+                resolved = resolve(target, cur, numLinks, ec);
+                if (ec) {
+                    return {};
+                }
+                resolvedIsDir = isDirectory(resolved);
+            }
+            else {
+                resolved = std::move(candidate);
+            }
+            addLink(cur, name, resolved, resolvedIsDir);
+            // 后面还有/（包括末尾的/）时必须是目录：
+            if (end < path.size() && !resolvedIsDir) {
+                ec = std::make_error_code(std::errc::not_a_directory);
+                return {};
+            }
+            cur = std::move(resolved);
+        }
+        return cur;
+    }
+#endif
+public:
+    // checkInterval为max()时不检查mtime，只能通过flush()/invalidate()使缓存失效：
+    explicit CanonicalCache(std::chrono::nanoseconds interval = std::chrono::nanoseconds::max())
+     : checkInterval{interval} {
+    }
+
+    std::string canonical(std::string_view p, std::error_code& ec) {
+        ec.clear();
+        if (p.empty()) {
+            ec = std::make_error_code(std::errc::no_such_file_or_directory);
+            return {};
+        }
+#ifdef _MSC_VER
+        return std::filesystem::canonical(std::filesystem::path{p}, ec).string();
+#else
+        std::string absPath;
+        if (p[0] != '/') {
+            absPath = std::filesystem::current_path(ec).string();
+            if (ec) {
+                return {};
+            }
+            absPath += '/';
+            absPath += p;
+            p = absPath;
+        }
+        std::string result;
+        if (lookup(p, result, ec)) {
+            numHits.fetch_add(1, std::memory_order_relaxed);
+            return ec ? std::string{} : result;
+        }
+        int numLinks = 0;
+        result = resolve(p, "/", numLinks, ec);
+        return ec ? std::string{} : result;
+#endif
+    }
+
+    std::filesystem::path canonical(const std::filesystem::path& p) {
+        std::error_code ec;
+        auto result = canonical(p.native(), ec);
+        if (ec) {
+            throw std::filesystem::filesystem_error{"canonical", p, ec};
+        }
+        return result;
+    }
+
+    void flush() {
+        std::unique_lock lk{mx};
+        nodes.clear();
+    }
+
+    // 清空一个（规范路径表示的）目录的缓存：
+    void invalidate(const std::string& dir) {
+        std::unique_lock lk{mx};
+        if (Node* n = findNode(dir); n != nullptr) {
+            n->links.clear();
+            n->names.clear();
+        }
+    }
+
+    // 命中和未命中的次数（快速路径的一次命中计为一次，慢速路径按组件计数）：
+    std::uint64_t hits() const {
+        return numHits.load();
+    }
+    std::uint64_t misses() const {
+        return numMisses.load();
+    }
+};
+
+#endif  // CANONCACHE_HPP
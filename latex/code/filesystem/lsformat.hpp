@@ -0,0 +1,143 @@
+#ifndef LSFORMAT_HPP
+#define LSFORMAT_HPP
+
+#include <filesystem>
+#include <chrono>
+#include <array>
+#include <ctime>            // for std::tm, std::mktime(), std::strftime()
+#include <cstring>          // for std::memcpy()
+
+/********************************************
+* ls -l风格的列表需要的格式化函数，结果都写入调用者的缓冲区，不分配内存：
+* - formatPerms(pm, out)：和permAsString.hpp中的asString()结果相同（9个字符），
+*   但是直接从512项的查找表中复制
+* - typeChar(type)：ls -l中第一列的文件类型字符
+* - FileTimeFormatter：和ftimeAsString.hpp中的asString()结果相同（24个字符，ctime()的格式），
+*   但是：
+*   - 两个时钟之间的差值只在构造时计算一次（不再是每个文件调用两次now()）
+*   - 使用localtime_r()/localtime_s()而不是非线程安全的ctime()
+*   - 每个线程缓存最近用到的512天的日期部分（按天直接映射），
+*     缓存的日期内的时间只需要计算时分秒（有夏令时切换的那一天不缓存）
+********************************************/
+
+namespace lsformat_detail {
+
+    constexpr std::array<std::array<char, 9>, 512> makePermsTable() {
+        std::array<std::array<char, 9>, 512> table{};
+        for (int m = 0; m < 512; ++m) {
+            for (int i = 0; i < 9; ++i) {
+                // 从最高位（owner_read）开始：
+                table[m][i] = (m & (0400 >> i)) ? "rwx"[i % 3] : '-';
+            }
+        }
+        return table;
+    }
+
+    inline constexpr auto permsTable = makePermsTable();
+
+    inline bool localTime(std::time_t t, std::tm& tm) {
+#ifdef _MSC_VER
+        return localtime_s(&tm, &t) == 0;
+#else
+        return localtime_r(&t, &tm) != nullptr;
+#endif
+    }
+
+    inline void put2(char* out, int v) {
+        out[0] = static_cast<char>('0' + v / 10);
+        out[1] = static_cast<char>('0' + v % 10);
+    }
+}
+
+// 向out写入9个字符：
+inline void formatPerms(std::filesystem::perms pm, char* out)
+{
+    std::memcpy(out, lsformat_detail::permsTable[static_cast<unsigned>(pm) & 0777].data(), 9);
+}
+
+inline char typeChar(std::filesystem::file_type type)
+{
+    using ft = std::filesystem::file_type;
+    switch (type) {
+        case ft::directory: return 'd';
+        case ft::symlink:   return 'l';
+        case ft::block:     return 'b';
+        case ft::character: return 'c';
+        case ft::fifo:      return 'p';
+        case ft::socket:    return 's';
+        default:            return '-';
+    }
+}
+
+class FileTimeFormatter
+{
+private:
+    using system_clock = std::chrono::system_clock;
+    using file_clock = std::filesystem::file_time_type::clock;
+
+    system_clock::duration offset;      // system_clock和文件时钟的差值
+
+    // [dayBegin, dayEnd)内的时间共享日期部分：
+    struct DayCache {
+        std::time_t dayBegin = 1;
+        std::time_t dayEnd = 0;         // 初始时为空区间
+        char text[24];                  // "Www Mmm dd hh:mm:ss yyyy"
+    };
+
+    static void fillDay(DayCache& c, std::time_t t) {
+        std::tm tm{};
+        if (!lsformat_detail::localTime(t, tm)) {
+            std::memcpy(c.text, "??? ??? ?? ??:??:?? ????", 24);
+            c.dayBegin = 1;
+            c.dayEnd = 0;
+            return;
+        }
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%a %b %e %H:%M:%S %Y", &tm);
+        std::memcpy(c.text, buf, 24);
+        // 当天的开始和结束（本地时间），如果这一天不是正好24小时（夏令时切换）就不缓存：
+        std::tm begin = tm;
+        begin.tm_hour = begin.tm_min = begin.tm_sec = 0;
+        begin.tm_isdst = -1;
+        std::tm end = begin;
+        ++end.tm_mday;
+        c.dayBegin = std::mktime(&begin);
+        c.dayEnd = std::mktime(&end);
+        if (c.dayBegin == -1 || c.dayEnd - c.dayBegin != 24 * 60 * 60) {
+            c.dayBegin = 1;
+            c.dayEnd = 0;
+        }
+    }
+public:
+    FileTimeFormatter()
+     : offset{std::chrono::duration_cast<system_clock::duration>(
+                  system_clock::now().time_since_epoch()
+                  - file_clock::now().time_since_epoch())} {
+    }
+
+    std::time_t toTimeT(std::filesystem::file_time_type ft) const {
+        return system_clock::to_time_t(system_clock::time_point{
+                   std::chrono::duration_cast<system_clock::duration>(ft.time_since_epoch())
+                   + offset});
+    }
+
+    // 向out写入24个字符（和ctime()的格式相同，但是没有换行符）：
+    void format(std::filesystem::file_time_type ft, char* out) const {
+        // 每个线程的缓存，一个本地日期最多对应两个槽：
+        thread_local DayCache days[512];
+        std::time_t t = toTimeT(ft);
+        DayCache& cache = days[static_cast<std::size_t>(t / (24 * 60 * 60)) % 512];
+        if (t < cache.dayBegin || t >= cache.dayEnd) {
+            fillDay(cache, t);
+            std::memcpy(out, cache.text, 24);
+            return;
+        }
+        std::memcpy(out, cache.text, 24);
+        int secs = static_cast<int>(t - cache.dayBegin);
+        lsformat_detail::put2(out + 11, secs / 3600);
+        lsformat_detail::put2(out + 14, secs / 60 % 60);
+        lsformat_detail::put2(out + 17, secs % 60);
+    }
+};
+
+#endif  // LSFORMAT_HPP
@@ -0,0 +1,213 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <filesystem>
+#include <chrono>
+#include <charconv>     // for std::to_chars()
+#include <cstdio>       // for std::fwrite()
+#include <cstring>      // for std::strlen()
+#include <cstdlib>      // for std::atoi()
+#include <system_error>
+#ifndef _MSC_VER
+#include <cerrno>
+#include <sys/stat.h>   // for stat(), lstat()
+#endif
+#include "permAsString.hpp"
+#include "ftimeAsString.hpp"
+#include "lsformat.hpp"
+
+namespace fs = std::filesystem;
+
+struct Entry {
+    fs::file_type type;
+    fs::perms perms;
+    std::uintmax_t size;
+    fs::file_time_type mtime;
+    std::string name;
+};
+
+#ifndef _MSC_VER
+fs::file_time_type::duration sinceEpoch(const struct timespec& ts)
+{
+    return std::chrono::duration_cast<fs::file_time_type::duration>(
+               std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec});
+}
+#endif
+
+// 和ls -l一样，符号链接显示链接本身的大小（目标路径的长度）和修改时间；
+// 无法读取的项输出错误信息并跳过：
+std::vector<Entry> readEntries(const fs::path& dir)
+{
+    std::vector<Entry> entries;
+#ifndef _MSC_VER
+    // lstat()得到的时间换算成file_time_type：用目录本身的两种修改时间确定两种纪元的差
+    struct stat dirSt;
+    if (::stat(dir.c_str(), &dirSt) != 0) {
+        throw fs::filesystem_error{"stat", dir, std::error_code{errno, std::generic_category()}};
+    }
+    auto epoch = fs::last_write_time(dir) - sinceEpoch(dirSt.st_mtim);
+#endif
+    for (const auto& e : fs::directory_iterator{dir}) {
+        std::error_code ec;
+        auto st = e.symlink_status(ec);
+        Entry entry{st.type(), st.permissions(), 0, {}, e.path().filename().string()};
+        if (!ec && st.type() == fs::file_type::symlink) {
+#ifndef _MSC_VER
+            struct stat linkSt;
+            if (::lstat(e.path().c_str(), &linkSt) != 0) {
+                ec.assign(errno, std::generic_category());
+            }
+            else {
+                entry.size = static_cast<std::uintmax_t>(linkSt.st_size);
+                entry.mtime = epoch + sinceEpoch(linkSt.st_mtim);
+            }
+#else
+            // Windows上没有不跟随符号链接的last_write_time()，只有大小是链接本身的：
+            entry.size = fs::read_symlink(e.path(), ec).native().size();
+            entry.mtime = fs::file_time_type{};
+#endif
+        }
+        else if (!ec) {
+            entry.size = st.type() == fs::file_type::regular ? e.file_size(ec) : 0;
+            if (!ec) {
+                entry.mtime = e.last_write_time(ec);
+            }
+        }
+        if (ec) {
+            std::cerr << "lsl: " << e.path().string() << ": " << ec.message() << '\n';
+            continue;
+        }
+        entries.push_back(std::move(entry));
+    }
+    return entries;
+}
+
+// 使用permAsString.hpp和ftimeAsString.hpp的版本：
+void listStd(const std::vector<Entry>& entries, std::string& out)
+{
+    for (const auto& e : entries) {
+        out += typeChar(e.type);
+        out += asString(e.perms);
+        out += ' ';
+        out += std::to_string(e.size);
+        out += ' ';
+        out += asString(e.mtime);
+        out += ' ';
+        out += e.name;
+        out += '\n';
+    }
+}
+
+// 所有的结果都直接写入缓冲区：
+void listFast(const std::vector<Entry>& entries, const FileTimeFormatter& fmt, std::string& out)
+{
+    std::size_t used = out.size();
+    for (const auto& e : entries) {
+        std::size_t need = 1 + 9 + 1 + 20 + 1 + 24 + 1 + e.name.size() + 1;
+        if (out.size() < used + need) {
+            out.resize((used + need) * 2);
+        }
+        char* p = out.data() + used;
+        *p++ = typeChar(e.type);
+        formatPerms(e.perms, p);
+        p += 9;
+        *p++ = ' ';
+        p = std::to_chars(p, p + 20, e.size).ptr;
+        *p++ = ' ';
+        fmt.format(e.mtime, p);
+        p += 24;
+        *p++ = ' ';
+        e.name.copy(p, e.name.size());
+        p += e.name.size();
+        *p++ = '\n';
+        used = p - out.data();
+    }
+    out.resize(used);
+}
+
+template<typename F>
+double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    return diff.count();
+}
+
+// 创建num个文件，修改时间分布在过去的一年中：
+void createFiles(const fs::path& dir, int num)
+{
+    create_directories(dir);
+    auto now = fs::file_time_type::clock::now();
+    for (int i = 0; i < num; ++i) {
+        fs::path p = dir / ("file" + std::to_string(i));
+        std::ofstream{p} << std::string(i % 1000, 'x');
+        last_write_time(p, now - std::chrono::minutes{i * 53 % (365 * 24 * 60)});
+        permissions(p, static_cast<fs::perms>(i % 512 | 0600));
+    }
+    create_symlink("file1", dir / "link");
+    create_symlink("missing", dir / "dangling");
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string{argv[1]} != "-bench") {
+        // 列出目录argv[1]的内容：
+        std::string out;
+        listFast(readEntries(argv[1]), FileTimeFormatter{}, out);
+        std::fwrite(out.data(), 1, out.size(), stdout);
+        return 0;
+    }
+
+    // 基准测试：lsl -bench [dir] [numFiles] [rounds]
+    fs::path dir{argc > 2 ? argv[2] : "tmp/lsl"};
+    int numFiles = argc > 3 ? std::atoi(argv[3]) : 10'000;
+    int rounds = argc > 4 ? std::atoi(argv[4]) : 100;
+    if (!exists(dir)) {
+        std::cout << "creating " << numFiles << " files in " << dir.string() << '\n';
+        createFiles(dir, numFiles);
+    }
+    auto entries = readEntries(dir);
+
+    // 检查结果：权限和asString()相同，时间和同一个time_t的ctime()相同
+    FileTimeFormatter fmt;
+    int errors = 0;
+    for (const auto& e : entries) {
+        char buf[24];
+        formatPerms(e.perms, buf);
+        if (std::string_view{buf, 9} != asString(e.perms)) {
+            ++errors;
+        }
+        fmt.format(e.mtime, buf);
+        std::time_t t = fmt.toTimeT(e.mtime);
+        const char* expected = std::ctime(&t);
+        if (std::string_view{buf, 24} != std::string_view{expected, std::strlen(expected) - 1}) {
+            ++errors;
+        }
+        // 符号链接的大小是目标路径的长度（不跟随链接）：
+        if (e.type == fs::file_type::symlink
+            && e.size != fs::read_symlink(dir / e.name).native().size()) {
+            ++errors;
+        }
+    }
+    std::cout << entries.size() << " entries checked: " << (errors == 0 ? "OK" : "ERROR") << '\n';
+
+    std::string out;
+    double t1 = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            out.clear();
+            listStd(entries, out);
+        }
+    });
+    std::size_t len1 = out.size();
+    double t2 = measure([&] {
+        for (int r = 0; r < rounds; ++r) {
+            out.clear();
+            listFast(entries, fmt, out);
+        }
+    });
+    std::cout << rounds << " x " << entries.size() << " lines with asString(): " << t1
+              << "ms, with lsformat.hpp: " << t2 << "ms (" << len1 << " / " << out.size()
+              << " bytes)\n";
+}
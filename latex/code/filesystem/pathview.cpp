@@ -0,0 +1,128 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>    // for remove_if()
+#include <cstdlib>      // for std::atoi()
+#include "pathview.hpp"
+
+namespace fs = std::filesystem;
+
+// 用std::filesystem::path的迭代器计算共同前缀，用于检查：
+std::string commonPrefixStd(const fs::path& a, const fs::path& b)
+{
+    fs::path result;
+    for (auto i = a.begin(), j = b.begin();
+         i != a.end() && j != b.end() && !i->empty() && *i == *j; ++i, ++j) {
+        result /= *i;
+    }
+    return result.string();
+}
+
+// 由几种组件随机组合成的路径（包括"."、".."、多余的和末尾的分隔符）：
+std::vector<std::string> randomPaths(int num, unsigned seed)
+{
+    static const char* parts[] = {"a", "bb", "src", "include", ".", "..", "", "x.cpp"};
+    std::mt19937 eng{seed};
+    std::uniform_int_distribution<int> part{0, 7}, depth{0, 8}, coin{0, 3};
+    std::vector<std::string> paths;
+    paths.reserve(num);
+    for (int i = 0; i < num; ++i) {
+        std::string s = coin(eng) == 0 ? "/" : "";
+        for (int d = depth(eng); d > 0; --d) {
+            s += parts[part(eng)];
+            if (d > 1 || coin(eng) == 0) {
+                s += '/';
+            }
+        }
+        paths.push_back(std::move(s));
+    }
+    return paths;
+}
+
+template<typename F>
+double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    return diff.count();
+}
+
+int main(int argc, char* argv[])
+{
+    int num = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    // 和std::filesystem的结果比较：
+    auto tests = randomPaths(200'000, 1);
+    auto bases = randomPaths(50, 2);
+    char buf[1024];
+    int errors = 0;
+    auto check = [&] (const char* op, std::string_view mine, const std::string& expected,
+                      const std::string& p, const std::string& q) {
+        if (mine != expected) {
+            if (++errors <= 10) {
+                std::cout << op << "(\"" << p << "\", \"" << q << "\"): \"" << mine
+                          << "\" instead of \"" << expected << "\"\n";
+            }
+        }
+    };
+    for (std::size_t i = 0; i < tests.size(); ++i) {
+        const std::string& p = tests[i];
+        const std::string& q = bases[i % bases.size()];
+        if (p.find_first_not_of('/') == std::string::npos && p.size() > 1) {
+            // 按照标准"//"应该规范化为"/"，但是libstdc++返回原样的"//"
+            continue;
+        }
+        auto n = normalize(p, buf, sizeof(buf));
+        check("normalize", {buf, n}, fs::path{p}.lexically_normal().string(), p, "");
+        n = relative(p, q, buf, sizeof(buf));
+        check("relative", {buf, n}, fs::path{p}.lexically_relative(q).string(), p, q);
+        n = join(q, p, buf, sizeof(buf));
+        check("join", {buf, n}, (fs::path{q} / p).string(), q, p);
+        fs::path np{fs::path{p}.lexically_normal()}, nq{fs::path{q}.lexically_normal()};
+        check("commonPrefix", path_view{commonPrefix(np.string(), nq.string())}.native(),
+              commonPrefixStd(np, nq), np.string(), nq.string());
+    }
+    std::cout << tests.size() << " paths checked against std::filesystem: "
+              << (errors == 0 ? "OK" : "ERROR") << '\n';
+
+    // 批量处理的速度：
+    // 和上面的检查一样去掉只有"/"的路径（libstdc++把"//"规范化为"//"，而normalize()得到"/"），
+    // 这样两边处理的是相同的输入，结果的总长度也相同：
+    auto paths = randomPaths(num, 3);
+    paths.erase(std::remove_if(paths.begin(), paths.end(),
+                               [] (const std::string& p) {
+                                   return p.size() > 1
+                                          && p.find_first_not_of('/') == std::string::npos;
+                               }),
+                paths.end());
+    std::string base{"/usr/src/include/a/bb"};
+    std::size_t sum = 0;
+    double t1 = measure([&] {
+        for (const auto& p : paths) {
+            sum += fs::path{p}.lexically_normal().native().size();
+        }
+    });
+    std::string out;
+    std::vector<std::string_view> views;
+    double t2 = measure([&] {
+        normalizeBatch(paths.begin(), paths.end(), out, views);
+    });
+    std::cout << paths.size() << " x lexically_normal(): " << t1 << "ms, normalizeBatch(): " << t2
+              << "ms (total length " << sum << " / " << out.size() << ")\n";
+
+    sum = 0;
+    t1 = measure([&] {
+        for (const auto& p : paths) {
+            sum += fs::path{p}.lexically_relative(base).native().size();
+        }
+    });
+    t2 = measure([&] {
+        relativeBatch(paths.begin(), paths.end(), base, out, views);
+    });
+    std::cout << paths.size() << " x lexically_relative(): " << t1 << "ms, relativeBatch(): " << t2
+              << "ms (total length " << sum << " / " << out.size() << ")\n";
+}
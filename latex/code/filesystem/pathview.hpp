@@ -0,0 +1,357 @@
+#ifndef PATHVIEW_HPP
+#define PATHVIEW_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iterator>     // for std::forward_iterator_tag
+#include <cstddef>      // for std::size_t, std::ptrdiff_t
+
+/********************************************
+* path_view：只引用一个string_view的POSIX路径（分隔符为'/'，没有root-name），
+* 对应于std::filesystem::path的纯词法操作，但是不分配内存：
+* - normalize(p, out, cap)：和p.lexically_normal()相同
+* - relative(p, base, out, cap)：和p.lexically_relative(base)相同
+* - join(base, p, out, cap)：和base / p相同
+* - commonPrefix(a, b)：a和b共同的开头部分（按组件比较），返回a的子视图
+* 结果写入调用者的缓冲区[out, out+cap)，返回结果的长度，
+* 缓冲区不够时返回path_view::npos（缓冲区大小为输入长度加1时总是足够的）
+* normalizeBatch()/relativeBatch()把大量路径的结果写入同一个字符串，
+* 只需要很少次的内存分配
+* 和symlink.hpp中的relative()不同，这里的操作都不会访问文件系统
+* 注意：按照标准，只由分隔符组成的路径（例如"//"）规范化为"/"，
+*      而libstdc++的lexically_normal()会原样返回它
+********************************************/
+
+class path_view
+{
+private:
+    std::string_view str;
+public:
+    static constexpr std::size_t npos = std::string_view::npos;
+
+    constexpr path_view() = default;
+    constexpr path_view(std::string_view s) : str{s} {
+    }
+    constexpr path_view(const char* s) : str{s} {
+    }
+    path_view(const std::string& s) : str{s} {
+    }
+
+    constexpr std::string_view native() const {
+        return str;
+    }
+    constexpr bool empty() const {
+        return str.empty();
+    }
+    constexpr bool isAbsolute() const {
+        return !str.empty() && str[0] == '/';
+    }
+
+    // 和std::filesystem::path一样遍历所有的文件名，但是不包括根目录：
+    // 多个连续的分隔符视为一个，以分隔符结尾时最后一个元素为空字符串
+    class iterator {
+    private:
+        std::string_view str;
+        std::size_t pos = npos;     // npos表示末尾
+        std::size_t len = 0;
+
+        void setElement(std::size_t p) {
+            pos = p;
+            auto e = str.find('/', p);
+            len = (e == npos ? str.size() : e) - p;
+        }
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = std::string_view;
+
+        iterator() = default;
+        explicit iterator(std::string_view s) : str{s} {
+            auto p = s.find_first_not_of('/');
+            if (p != npos) {
+                setElement(p);
+            }
+        }
+        std::string_view operator*() const {
+            return str.substr(pos, len);
+        }
+        // 当前元素在整个字符串中的结束位置：
+        std::size_t endOffset() const {
+            return pos + len;
+        }
+        iterator& operator++() {
+            auto e = pos + len;
+            if (e >= str.size()) {
+                pos = npos;
+                return *this;
+            }
+            auto q = str.find_first_not_of('/', e);
+            if (q == npos) {
+                pos = str.size();   // 以分隔符结尾：最后一个元素为空
+                len = 0;
+            }
+            else {
+                setElement(q);
+            }
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator tmp{*this};
+            ++*this;
+            return tmp;
+        }
+        bool operator== (const iterator& other) const {
+            return pos == other.pos;
+        }
+        bool operator!= (const iterator& other) const {
+            return pos != other.pos;
+        }
+    };
+
+    iterator begin() const {
+        return iterator{str};
+    }
+    iterator end() const {
+        return iterator{};
+    }
+};
+
+namespace pathview_detail {
+
+    // 向固定大小的缓冲区写入，空间不够时记录失败：
+    class Writer {
+    private:
+        char* out;
+        std::size_t cap;
+        std::size_t len = 0;
+        bool ok = true;
+    public:
+        Writer(char* o, std::size_t c) : out{o}, cap{c} {
+        }
+        void put(char c) {
+            if (len < cap) {
+                out[len++] = c;
+            }
+            else {
+                ok = false;
+            }
+        }
+        void put(std::string_view s) {
+            if (cap - len >= s.size()) {
+                s.copy(out + len, s.size());
+                len += s.size();
+            }
+            else {
+                ok = false;
+            }
+        }
+        // 和path::operator/=一样追加一个元素：
+        void append(std::string_view elem) {
+            if (len > 0 && out[len - 1] != '/') {
+                put('/');
+            }
+            put(elem);
+        }
+        std::size_t size() const {
+            return len;
+        }
+        void truncate(std::size_t n) {
+            len = n;
+        }
+        std::string_view written() const {
+            return std::string_view{out, len};
+        }
+        std::size_t result() const {
+            return ok ? len : path_view::npos;
+        }
+    };
+}
+
+inline std::size_t normalize(path_view p, char* out, std::size_t cap)
+{
+    pathview_detail::Writer w{out, cap};
+    if (p.empty()) {
+        return 0;
+    }
+    std::size_t rootLen = 0;
+    if (p.isAbsolute()) {
+        w.put('/');
+        rootLen = 1;
+    }
+    // 已经写入的组件：先是若干个".."，然后是numNames个普通的文件名
+    int numNames = 0;
+    bool trailing = false;      // 结果是否以分隔符结尾
+    for (std::string_view elem : p) {
+        if (elem.empty() || elem == ".") {
+            trailing = true;
+        }
+        else if (elem == "..") {
+            trailing = true;
+            if (numNames > 0) {
+                // 删除最后一个文件名（以及它前面的分隔符）：
+                auto s = w.written();
+                auto slash = s.rfind('/');
+                w.truncate(slash == std::string_view::npos || slash < rootLen ? rootLen : slash);
+                --numNames;
+            }
+            else if (rootLen == 0) {
+                w.append("..");     // 根目录之后的".."被删除
+            }
+        }
+        else {
+            trailing = false;
+            w.append(elem);
+            ++numNames;
+        }
+    }
+    if (trailing && numNames > 0) {
+        w.put('/');
+    }
+    if (w.size() == 0) {
+        w.put('.');
+    }
+    return w.result();
+}
+
+inline std::size_t relative(path_view p, path_view base, char* out, std::size_t cap)
+{
+    pathview_detail::Writer w{out, cap};
+    if (p.isAbsolute() != base.isAbsolute()) {
+        return 0;   // 空路径
+    }
+    auto a = p.begin(), aEnd = p.end();
+    auto b = base.begin(), bEnd = base.end();
+    while (a != aEnd && b != bEnd && *a == *b) {
+        ++a;
+        ++b;
+    }
+    if (a == aEnd && b == bEnd) {
+        w.put('.');
+        return w.result();
+    }
+    int n = 0;
+    for (; b != bEnd; ++b) {
+        std::string_view elem = *b;
+        if (elem == "..") {
+            --n;
+        }
+        else if (!elem.empty() && elem != ".") {
+            ++n;
+        }
+    }
+    if (n < 0) {
+        return 0;
+    }
+    if (n == 0 && (a == aEnd || (*a).empty())) {
+        w.put('.');
+        return w.result();
+    }
+    for (; n > 0; --n) {
+        w.append("..");
+    }
+    for (; a != aEnd; ++a) {
+        w.append(*a);
+    }
+    return w.result();
+}
+
+inline std::size_t join(path_view base, path_view p, char* out, std::size_t cap)
+{
+    pathview_detail::Writer w{out, cap};
+    if (!p.isAbsolute()) {
+        w.put(base.native());
+        if (!base.empty() && base.native().back() != '/') {
+            w.put('/');     // p为空时也添加（base / ""以分隔符结尾）
+        }
+    }
+    w.put(p.native());
+    return w.result();
+}
+
+inline path_view commonPrefix(path_view a, path_view b)
+{
+    if (a.isAbsolute() != b.isAbsolute()) {
+        return path_view{};
+    }
+    std::size_t end = a.isAbsolute() ? 1 : 0;
+    auto i = a.begin(), iEnd = a.end();
+    auto j = b.begin(), jEnd = b.end();
+    for (; i != iEnd && j != jEnd && !(*i).empty() && *i == *j; ++i, ++j) {
+        end = i.endOffset();
+    }
+    return path_view{a.native().substr(0, end)};
+}
+
+namespace pathview_detail {
+
+    // 对[first, last)中的每个路径调用op(path, out, cap)，结果都写入buf：
+    template<typename InputIt, typename Op>
+    void batch(InputIt first, InputIt last, std::string& buf,
+               std::vector<std::string_view>& views, Op op) {
+        std::vector<std::size_t> ends;
+        std::size_t used = 0;
+        for (; first != last; ++first) {
+            path_view p{std::string_view{*first}};
+            std::size_t bound = op.bound(p);
+            if (buf.size() < used + bound) {
+                buf.resize((used + bound) * 2);     // 按指数增长
+            }
+            used += op(p, buf.data() + used, bound);
+            ends.push_back(used);
+        }
+        buf.resize(used);
+        views.clear();
+        views.reserve(ends.size());
+        std::size_t begin = 0;
+        for (auto e : ends) {
+            views.emplace_back(buf.data() + begin, e - begin);
+            begin = e;
+        }
+    }
+
+    struct NormalizeOp {
+        std::size_t bound(path_view p) const {
+            return p.native().size() + 1;
+        }
+        std::size_t operator() (path_view p, char* out, std::size_t cap) const {
+            return normalize(p, out, cap);
+        }
+    };
+
+    struct RelativeOp {
+        path_view base;
+        std::size_t baseElems = 0;
+        explicit RelativeOp(path_view b) : base{b} {
+            for (auto pos = b.begin(); pos != b.end(); ++pos) {
+                ++baseElems;
+            }
+        }
+        std::size_t bound(path_view p) const {
+            return baseElems * 3 + p.native().size() + 1;
+        }
+        std::size_t operator() (path_view p, char* out, std::size_t cap) const {
+            return relative(p, base, out, cap);
+        }
+    };
+}
+
+// views中的第i个元素是第i个路径的lexically_normal()：
+template<typename InputIt>
+void normalizeBatch(InputIt first, InputIt last,
+                    std::string& buf, std::vector<std::string_view>& views)
+{
+    pathview_detail::batch(first, last, buf, views, pathview_detail::NormalizeOp{});
+}
+
+// views中的第i个元素是第i个路径的lexically_relative(base)：
+template<typename InputIt>
+void relativeBatch(InputIt first, InputIt last, path_view base,
+                   std::string& buf, std::vector<std::string_view>& views)
+{
+    pathview_detail::batch(first, last, buf, views, pathview_detail::RelativeOp{base});
+}
+
+#endif  // PATHVIEW_HPP
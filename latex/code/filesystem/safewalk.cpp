@@ -0,0 +1,67 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <filesystem>
+#include <chrono>
+#include <cstdlib>      // for std::atoi()
+#include "safewalk.hpp"
+
+namespace fs = std::filesystem;
+
+// 创建numDirs个目录，每个目录中有：
+// - filesPerDir个文件和一个指向第一个文件的硬链接
+// - 一个指向根目录的符号链接（循环）和一个指向下一个目录的符号链接（重复）
+void createTree(const fs::path& root, int numDirs, int filesPerDir)
+{
+    create_directories(root);
+    for (int d = 0; d < numDirs; ++d) {
+        fs::path dir = root / ("d" + std::to_string(d));
+        create_directory(dir);
+        for (int f = 0; f < filesPerDir; ++f) {
+            std::ofstream{dir / ("f" + std::to_string(f))} << std::string(100, 'x');
+        }
+        if (filesPerDir > 0) {
+            create_hard_link(dir / "f0", dir / "hardlink");
+        }
+        create_directory_symlink(absolute(root), dir / "up");
+        create_directory_symlink("../d" + std::to_string((d + 1) % numDirs), dir / "next");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    fs::path root{argc > 1 ? argv[1] : "tmp/safewalk"};
+    int numDirs = argc > 2 ? std::atoi(argv[2]) : 1000;
+    int filesPerDir = argc > 3 ? std::atoi(argv[3]) : 100;
+    if (!exists(root)) {
+        std::cout << "creating " << numDirs << " directories with " << filesPerDir
+                  << " files and 2 symlinks each in " << root.string() << '\n';
+        createTree(root, numDirs, filesPerDir);
+    }
+
+    // 不跟随符号链接的标准迭代器（跟随的话会在循环中一直递归下去）：
+    auto start = std::chrono::steady_clock::now();
+    long entries = 0;
+    for (const auto& e : fs::recursive_directory_iterator{root}) {
+        entries += !e.path().empty();
+    }
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    std::cout << "recursive_directory_iterator (no symlinks): " << diff.count() << "ms, "
+              << entries << " entries\n";
+
+    for (unsigned threads : {1u, 4u, 16u}) {
+        safewalk::Stats stats;
+        safewalk::Options opts;
+        opts.threads = threads;
+        start = std::chrono::steady_clock::now();
+        safeWalk(root, stats, opts);
+        diff = std::chrono::steady_clock::now() - start;
+        std::cout << "safeWalk, " << threads << " threads: " << diff.count() << "ms\n"
+                  << "  " << stats.dirs << " dirs, " << stats.files << " files, "
+                  << stats.symlinks << " symlinks, " << stats.bytes << " bytes\n"
+                  << "  " << stats.cyclesAvoided << " cycles avoided, "
+                  << stats.duplicateDirs << " duplicate dirs skipped, "
+                  << stats.duplicateLinks << " hard links counted once, "
+                  << stats.errors << " errors\n";
+    }
+}
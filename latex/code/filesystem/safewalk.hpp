@@ -0,0 +1,286 @@
+#ifndef SAFEWALK_HPP
+#define SAFEWALK_HPP
+
+#include <filesystem>
+#include <system_error>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <memory>       // for std::shared_ptr
+#include <unordered_set>
+#include <functional>   // for std::hash
+#include <cstdint>
+#ifdef _MSC_VER
+#include <windows.h>    // for GetFileInformationByHandle()
+#else
+#include <cerrno>
+#include <sys/stat.h>   // for stat()
+#endif
+
+/********************************************
+* safeWalk(root, stats, opts, f)：并行地递归遍历目录树，并且跟随符号链接，
+* 但是和createfiles.cpp中使用follow_directory_symlink的recursive_directory_iterator不同：
+* - 用（设备号，inode号）识别目录，每个目录只会被遍历一次，
+*   所以symlink.hpp中创建的a/s -> top这样的循环不会导致无限递归
+* - 区分两种被跳过的目录：循环（指向自己的祖先）和重复（从其他路径已经到达过）
+* - countLinksOnce为true时有多个硬链接的文件只计算一次大小
+* - 已经访问过的（设备号，inode号）保存在分片加锁的并发哈希集合中
+* f(path, info)在工作线程中对每个条目调用（可以为空），所以必须是线程安全的
+********************************************/
+
+namespace safewalk {
+
+    struct FileId {
+        std::uint64_t dev;
+        std::uint64_t ino;
+        bool operator== (const FileId& other) const {
+            return dev == other.dev && ino == other.ino;
+        }
+    };
+
+    struct FileIdHash {
+        std::size_t operator() (const FileId& id) const {
+            return std::hash<std::uint64_t>{}(id.ino * 0x9e3779b97f4a7c15ULL ^ id.dev);
+        }
+    };
+
+    struct FileInfo {
+        FileId id;
+        std::uintmax_t size;
+        std::uintmax_t links;
+        bool isDir;
+        bool isRegular;
+        bool isSymlink;     // 路径本身是符号链接（其他信息是链接目标的）
+    };
+
+    // 获取文件（跟随符号链接）的信息：
+    inline bool getInfo(const std::filesystem::path& p, FileInfo& info, std::error_code& ec) {
+        std::error_code ec2;
+        info.isSymlink = std::filesystem::is_symlink(p, ec2);
+#ifdef _MSC_VER
+        HANDLE h = CreateFileW(p.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                               nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+        if (h == INVALID_HANDLE_VALUE) {
+            ec.assign(static_cast<int>(GetLastError()), std::system_category());
+            return false;
+        }
+        BY_HANDLE_FILE_INFORMATION fi;
+        bool ok = GetFileInformationByHandle(h, &fi);
+        CloseHandle(h);
+        if (!ok) {
+            ec.assign(static_cast<int>(GetLastError()), std::system_category());
+            return false;
+        }
+        info.id = {fi.dwVolumeSerialNumber,
+                   (std::uint64_t{fi.nFileIndexHigh} << 32) | fi.nFileIndexLow};
+        info.size = (std::uintmax_t{fi.nFileSizeHigh} << 32) | fi.nFileSizeLow;
+        info.links = fi.nNumberOfLinks;
+        info.isDir = (fi.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+        info.isRegular = !info.isDir;
+#else
+        struct stat st;
+        if (::stat(p.c_str(), &st) != 0) {
+            ec.assign(errno, std::generic_category());
+            return false;
+        }
+        info.id = {static_cast<std::uint64_t>(st.st_dev), static_cast<std::uint64_t>(st.st_ino)};
+        info.size = static_cast<std::uintmax_t>(st.st_size);
+        info.links = static_cast<std::uintmax_t>(st.st_nlink);
+        info.isDir = S_ISDIR(st.st_mode);
+        info.isRegular = S_ISREG(st.st_mode);
+#endif
+        ec.clear();
+        return true;
+    }
+
+    // 分片加锁的集合，不同的分片可以同时插入：
+    class ConcurrentIdSet {
+    private:
+        static constexpr std::size_t numShards = 64;
+        struct alignas(64) Shard {
+            std::mutex mx;
+            std::unordered_set<FileId, FileIdHash> ids;
+        };
+        Shard shards[numShards];
+    public:
+        // 第一次插入时返回true：
+        bool insert(const FileId& id) {
+            Shard& s = shards[FileIdHash{}(id) % numShards];
+            std::lock_guard lg{s.mx};
+            return s.ids.insert(id).second;
+        }
+    };
+
+    struct Options {
+        unsigned threads = 4;
+        bool followSymlinks = true;
+        bool countLinksOnce = true;
+    };
+
+    struct Stats {
+        std::atomic<std::uintmax_t> files{0};
+        std::atomic<std::uintmax_t> dirs{0};
+        std::atomic<std::uintmax_t> symlinks{0};
+        std::atomic<std::uintmax_t> bytes{0};
+        std::atomic<std::uintmax_t> cyclesAvoided{0};      // 指向祖先目录
+        std::atomic<std::uintmax_t> duplicateDirs{0};      // 其他路径已经到达过的目录
+        std::atomic<std::uintmax_t> duplicateLinks{0};     // 已经计算过的硬链接
+        std::atomic<std::uintmax_t> errors{0};
+    };
+
+    // 从根目录到某个目录的路径上所有目录的id（用于判断循环）：
+    struct Ancestors {
+        FileId id;
+        std::shared_ptr<const Ancestors> parent;
+
+        bool contains(const FileId& other) const {
+            for (const Ancestors* a = this; a != nullptr; a = a->parent.get()) {
+                if (a->id == other) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    template<typename F>
+    class Walker {
+    private:
+        struct Dir {
+            std::filesystem::path path;
+            std::shared_ptr<const Ancestors> chain;
+        };
+
+        Options opts;
+        F& callback;
+        Stats& stats;
+        ConcurrentIdSet dirIds;
+        ConcurrentIdSet fileIds;
+        std::mutex mx;
+        std::condition_variable cv;
+        std::deque<Dir> dirs;
+        std::size_t busy = 0;
+
+        void readDir(const Dir& dir) {
+            namespace fs = std::filesystem;
+            std::vector<Dir> subdirs;
+            std::error_code ec;
+            for (fs::directory_iterator pos{dir.path, fs::directory_options::skip_permission_denied,
+                                            ec}, end;
+                 !ec && pos != end; pos.increment(ec)) {
+                const fs::path& p = pos->path();
+                FileInfo info;
+                std::error_code ec2;
+                if (!getInfo(p, info, ec2)) {
+                    ++stats.errors;     // 例如悬空的符号链接
+                    continue;
+                }
+                if (info.isSymlink) {
+                    ++stats.symlinks;
+                    if (!opts.followSymlinks) {
+                        callback(p, info);
+                        continue;
+                    }
+                }
+                if (info.isDir) {
+                    if (!dirIds.insert(info.id)) {
+                        if (dir.chain->contains(info.id)) {
+                            ++stats.cyclesAvoided;
+                        }
+                        else {
+                            ++stats.duplicateDirs;
+                        }
+                        continue;
+                    }
+                    ++stats.dirs;
+                    callback(p, info);
+                    subdirs.push_back(Dir{p, std::make_shared<const Ancestors>(
+                                                 Ancestors{info.id, dir.chain})});
+                }
+                else {
+                    if (info.isRegular) {
+                        ++stats.files;
+                        if (opts.countLinksOnce && info.links > 1 && !fileIds.insert(info.id)) {
+                            ++stats.duplicateLinks;
+                        }
+                        else {
+                            stats.bytes += info.size;
+                        }
+                    }
+                    callback(p, info);
+                }
+            }
+            if (ec) {
+                ++stats.errors;
+            }
+            if (!subdirs.empty()) {
+                std::lock_guard lg{mx};
+                for (auto& d : subdirs) {
+                    dirs.push_back(std::move(d));
+                }
+                cv.notify_all();
+            }
+        }
+
+        void workerLoop() {
+            for (;;) {
+                Dir dir;
+                {
+                    std::unique_lock lk{mx};
+                    cv.wait(lk, [this] { return !dirs.empty() || busy == 0; });
+                    if (dirs.empty()) {
+                        return;     // 没有剩余的目录，并且没有线程还在读取目录
+                    }
+                    dir = std::move(dirs.front());
+                    dirs.pop_front();
+                    ++busy;
+                }
+                readDir(dir);
+                std::lock_guard lg{mx};
+                if (--busy == 0 && dirs.empty()) {
+                    cv.notify_all();
+                }
+            }
+        }
+    public:
+        Walker(Options o, F& f, Stats& s) : opts{o}, callback{f}, stats{s} {
+        }
+        void run(const std::filesystem::path& root) {
+            FileInfo info;
+            std::error_code ec;
+            if (!getInfo(root, info, ec) || !info.isDir) {
+                ++stats.errors;
+                return;
+            }
+            dirIds.insert(info.id);
+            dirs.push_back(Dir{root, std::make_shared<const Ancestors>(Ancestors{info.id, nullptr})});
+            std::vector<std::thread> workers;
+            for (unsigned i = 0; i < (opts.threads > 0 ? opts.threads : 1); ++i) {
+                workers.emplace_back([this] { workerLoop(); });
+            }
+            for (auto& t : workers) {
+                t.join();
+            }
+        }
+    };
+}
+
+template<typename F>
+void safeWalk(const std::filesystem::path& root, safewalk::Stats& stats,
+              safewalk::Options opts, F f)
+{
+    safewalk::Walker<F> walker{opts, f, stats};
+    walker.run(root);
+}
+
+inline void safeWalk(const std::filesystem::path& root, safewalk::Stats& stats,
+                     safewalk::Options opts = {})
+{
+    safeWalk(root, stats, opts, [] (const std::filesystem::path&, const safewalk::FileInfo&) {
+             });
+}
+
+#endif  // SAFEWALK_HPP
@@ -0,0 +1,115 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>      // for std::uintptr_t
+#include <cstdlib>      // for std::atoi(), std::atol()
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+#include "alignedalloc.hpp"
+
+bool isAligned(const void* p, std::size_t align)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+// 要求data按照32字节对齐的求和函数：
+float sum32(const float* data, std::size_t n)
+{
+#ifdef __AVX__
+    __m256 acc = _mm256_setzero_ps();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm256_add_ps(acc, _mm256_load_ps(data + i));   // 未对齐时会崩溃
+    }
+    alignas(32) float parts[8];
+    _mm256_store_ps(parts, acc);
+    float sum = 0;
+    for (float f : parts) {
+        sum += f;
+    }
+    for (; i < n; ++i) {
+        sum += data[i];
+    }
+    return sum;
+#else
+#ifdef __GNUC__
+    // 告诉编译器数据已经对齐，以便于它生成对齐的向量指令：
+    auto p = static_cast<const float*>(__builtin_assume_aligned(data, 32));
+#else
+    auto p = data;
+#endif
+    float sum = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        sum += p[i];
+    }
+    return sum;
+#endif
+}
+
+// 每个线程递增counters中属于自己的计数器：
+template<typename Counters, typename Get>
+double runCounters(int numThreads, long iterations, Counters& counters, Get get)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t] {
+            auto& c = get(counters[t]);
+            for (long i = 0; i < iterations; ++i) {
+                c.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    return diff.count();
+}
+
+int main(int argc, char* argv[])
+{
+    long iterations = argc > 1 ? std::atol(argv[1]) : 10'000'000;
+    int maxThreads = argc > 2 ? std::atoi(argv[2]) : 8;
+
+    // 可以直接用于SIMD的容器：
+    aligned_vector<float, 32> v(1001, 1.0f);
+    std::cout << "aligned_vector<float, 32>: "
+              << (isAligned(v.data(), 32) ? "aligned" : "NOT aligned")
+              << ", sum: " << sum32(v.data(), v.size()) << '\n';
+    // 只有对齐相同的分配器才相等（才能释放彼此分配的内存）：
+    std::cout << "allocator equality: "
+              << (aligned_allocator<float, 32>{} == aligned_allocator<int, 32>{}
+                  && aligned_allocator<float, 32>{} != aligned_allocator<float, 64>{}
+                  ? "OK" : "ERROR") << '\n';
+
+    // pmr容器：即使上游只保证默认对齐，所有分配也都是64字节对齐的
+    std::byte buf[4096];
+    std::pmr::monotonic_buffer_resource pool{buf, sizeof(buf)};
+    pmr::AlignedResource<64> aligned{&pool};
+    std::pmr::vector<char> c1{&aligned}, c2{&aligned};
+    c1.resize(3);
+    c2.resize(5);
+    std::cout << "pmr vectors: "
+              << (isAligned(c1.data(), 64) && isAligned(c2.data(), 64) ? "aligned"
+                                                                        : "NOT aligned")
+              << '\n';
+
+    std::cout << "sizeof(cache_padded<std::atomic<long>>): "
+              << sizeof(cache_padded<std::atomic<long>>) << '\n';
+
+    // 伪共享：相邻的计数器位于同一个cache line时，
+    // 每次递增都会使其他CPU上的cache line失效
+    for (int n = 1; n <= maxThreads; n *= 2) {
+        std::vector<std::atomic<long>> packed(n);
+        aligned_vector<cache_padded<std::atomic<long>>> padded(n);
+        double t1 = runCounters(n, iterations, packed,
+                                [] (auto& c) -> auto& { return c; });
+        double t2 = runCounters(n, iterations, padded,
+                                [] (auto& c) -> auto& { return *c; });
+        std::cout << n << " threads: packed " << t1 << "ms, padded " << t2 << "ms\n";
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef ALIGNEDALLOC_HPP
+#define ALIGNEDALLOC_HPP
+
+#include <cstddef>          // for std::size_t, std::max_align_t
+#include <new>              // for std::align_val_t
+#include <memory_resource>
+#include <vector>
+#include <limits>
+#include <utility>          // for std::forward(), std::in_place_t
+#include <type_traits>
+
+/********************************************
+* 和alignednew.hpp中的MyType32不同，对齐不再需要为每个类型单独实现operator new：
+* - aligned_allocator<T, Align>：总是按照Align字节对齐分配内存的分配器
+*   （使用C++17的对齐new，所以释放时也会传递对齐）
+* - pmr::AlignedResource<Align>：把所有分配的对齐提高到至少Align的memory_resource
+* - cache_padded<T>：独占一个（或者多个）cache line的T，用于避免伪共享
+* aligned_vector<float, 32>的data()可以直接传给要求32字节对齐的SIMD函数
+********************************************/
+
+// cache line的大小（没有使用std::hardware_destructive_interference_size，
+// 因为它的值可能随编译选项变化，从而改变类型的布局）：
+inline constexpr std::size_t cacheLineSize = 64;
+
+template<typename T, std::size_t Align = alignof(T)>
+class aligned_allocator
+{
+    static_assert((Align & (Align - 1)) == 0, "alignment must be a power of 2");
+    static_assert(Align >= alignof(T), "alignment must not be weaker than alignof(T)");
+public:
+    using value_type = T;
+    static constexpr std::size_t alignment = Align;
+
+    template<typename U>
+    struct rebind {
+        using other = aligned_allocator<U, (Align > alignof(U) ? Align : alignof(U))>;
+    };
+
+    aligned_allocator() noexcept = default;
+    template<typename U, std::size_t A>
+    aligned_allocator(const aligned_allocator<U, A>&) noexcept {
+    }
+
+    [[nodiscard]] T* allocate(std::size_t n) {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length{};
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Align}));
+    }
+    void deallocate(T* p, std::size_t n) noexcept {
+        ::operator delete(p, n * sizeof(T), std::align_val_t{Align});
+    }
+
+    // 对齐不同的分配器释放时使用不同的align_val_t，所以不能互相释放：
+    template<typename U, std::size_t A>
+    bool operator== (const aligned_allocator<U, A>&) const noexcept {
+        return A == Align;
+    }
+    template<typename U, std::size_t A>
+    bool operator!= (const aligned_allocator<U, A>&) const noexcept {
+        return A != Align;
+    }
+};
+
+template<typename T, std::size_t Align = cacheLineSize>
+using aligned_vector = std::vector<T, aligned_allocator<T, Align>>;
+
+namespace pmr {
+
+    // 把对齐提高到至少Align，然后交给上游的memory_resource：
+    template<std::size_t Align>
+    class AlignedResource : public std::pmr::memory_resource
+    {
+        static_assert((Align & (Align - 1)) == 0, "alignment must be a power of 2");
+    private:
+        std::pmr::memory_resource* upstream;
+    public:
+        explicit AlignedResource(std::pmr::memory_resource* us
+                                     = std::pmr::get_default_resource())
+         : upstream{us} {
+        }
+        std::pmr::memory_resource* upstream_resource() const {
+            return upstream;
+        }
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t align) override {
+            return upstream->allocate(bytes, align > Align ? align : Align);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+            upstream->deallocate(p, bytes, align > Align ? align : Align);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            auto op = dynamic_cast<const AlignedResource*>(&other);
+            return op != nullptr && op->upstream->is_equal(*upstream);
+        }
+    };
+}
+
+// 对齐到cache line并且填充到cache line大小的整数倍，
+// 所以数组中相邻的两个元素不会共享同一个cache line：
+template<typename T>
+struct alignas(cacheLineSize > alignof(T) ? cacheLineSize : alignof(T)) cache_padded
+{
+    T value;
+
+    cache_padded() = default;
+    template<typename... Args>
+    explicit cache_padded(std::in_place_t, Args&&... args)
+     : value(std::forward<Args>(args)...) {
+    }
+
+    T& operator*() noexcept { return value; }
+    const T& operator*() const noexcept { return value; }
+    T* operator->() noexcept { return &value; }
+    const T* operator->() const noexcept { return &value; }
+};
+
+#endif  // ALIGNEDALLOC_HPP
@@ -0,0 +1,102 @@
+#include "structbind1.hpp"
+#include "customerbatch.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>      // for std::atoi()
+
+template<typename F>
+double measure(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    return diff.count();
+}
+
+int main(int argc, char* argv[])
+{
+    int num = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    CustomerBatch batch;
+    batch.push_back("Tim", "Starr", 42);
+    for (auto [f, l, v] : batch) {      // f和l是string_view，v是long&
+        v += 10;
+        std::cout << "f/l/v:    " << f << ' ' << l << ' ' << v << '\n';
+    }
+    std::cout << "batch[0]: " << batch[0].firstname() << ' ' << batch[0].lastname() << ' '
+              << batch[0].value() << '\n';
+    const CustomerBatch& cbatch = batch;
+    auto [cf, cl, cv] = cbatch[0];      // 通过const的batch只能读取
+    static_assert(std::is_same_v<decltype(cf), std::string_view>);
+    static_assert(std::is_same_v<decltype(cv), const long&>);
+    std::cout << "const:    " << cf << ' ' << cl << ' ' << cv << '\n';
+
+    // 随机访问迭代器的所有比较和算术运算：
+    batch.push_back("Ann", "Li", 1);
+    batch.push_back("Jo", "Waters", 2);
+    auto b = cbatch.begin(), e = cbatch.end();
+    bool ok = 2 + b == b + 2 && e - b == 3 && b < e && e > b && b <= b && e >= b
+              && !(b > e) && (e - 1)[0].firstname() == "Jo" && (*(1 + b)).lastname() == "Li";
+    std::cout << "iterator: " << (ok ? "OK" : "ERROR") << '\n';
+
+    // 同样的数据分别存储在vector<Customer>和CustomerBatch中（名字的长度不同，有些超过SSO的长度）：
+    static const char* firstnames[] = {"Tim", "Bartholomew", "Ann", "Maximilian-Alexander",
+                                       "Jo", "Christopher"};
+    static const char* lastnames[] = {"Starr", "Waters", "Montgomery-Whitfield", "Li",
+                                      "Vanderbilt", "Oyelaran-Fitzgerald"};
+    std::mt19937 eng{42};
+    std::vector<Customer> coll;
+    coll.reserve(num);
+    batch = CustomerBatch{};
+    batch.reserve(num, num * 24);
+    for (int i = 0; i < num; ++i) {
+        const char* f = firstnames[eng() % 6];
+        const char* l = lastnames[eng() % 6];
+        long v = static_cast<long>(eng() % 1000);
+        coll.emplace_back(f, l, v);
+        batch.push_back(f, l, v);
+    }
+
+    // 结构化绑定遍历所有的属性：
+    long sum1 = 0, sum2 = 0;
+    double t1 = measure([&] {
+        for (const auto& c : coll) {
+            auto [f, l, v] = c;     // 通过getFirst()/getLast()复制字符串
+            sum1 += f.size() + l.size() + v;
+        }
+    });
+    double t2 = measure([&] {
+        for (auto [f, l, v] : batch) {
+            sum2 += f.size() + l.size() + v;
+        }
+    });
+    std::cout << num << " x auto [f, l, v]: vector<Customer>: " << t1 << "ms, CustomerBatch: "
+              << t2 << "ms, " << (sum1 == sum2 ? "OK" : "ERROR") << '\n';
+
+    // 只读取value：
+    sum1 = sum2 = 0;
+    t1 = measure([&] {
+        for (const auto& c : coll) {
+            sum1 += c.getValue();
+        }
+    });
+    t2 = measure([&] {
+        sum2 = batch.sumValues();
+    });
+    std::cout << num << " x getValue(): vector<Customer>: " << t1 << "ms, sumValues(): "
+              << t2 << "ms, " << (sum1 == sum2 ? "OK" : "ERROR") << '\n';
+
+    // 通过绑定的long&修改batch中的值：
+    for (auto [f, l, v] : batch) {
+        v += static_cast<long>(f.size());
+    }
+    long expected = 0;
+    for (const auto& c : coll) {
+        expected += c.getValue() + static_cast<long>(c.getFirst().size());
+    }
+    std::cout << "modified through bindings: " << (batch.sumValues() == expected ? "OK" : "ERROR")
+              << '\n';
+}
@@ -0,0 +1,237 @@
+#ifndef CUSTOMERBATCH_HPP
+#define CUSTOMERBATCH_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <numeric>      // for std::accumulate()
+#include <iterator>     // for std::random_access_iterator_tag
+#include <utility>      // for tuple-like API
+#include <type_traits>  // for std::conditional_t, std::is_const_v
+#include <limits>
+#include <stdexcept>    // for std::length_error
+#include <cstdint>
+#include <cstddef>      // for std::ptrdiff_t
+
+/********************************************
+* CustomerBatch：按列存储很多个Customer（见customer1.hpp和customer2.hpp）：
+* - 名和姓存放在同一个字符串（arena）中，每列只记录（偏移，长度）
+* - value存放在单独的vector<long>中，所以只读取value的操作
+*   （例如sumValues()）只访问这一列的内存
+* 遍历时得到的是轻量的代理对象（只有一个指针和一个下标），
+* 和structbind2.hpp一样通过tuple-like API支持结构化绑定：
+*   for (auto [f, l, v] : batch)    // f和l是string_view，v是long&
+* 所以绑定时不会复制字符串，而修改v会直接修改batch中的值
+* 注意：添加新的元素之后，之前得到的string_view可能会失效（arena可能重新分配）
+*      偏移和长度是32位的，所以所有名字的总长度不能超过4GiB（超过时抛出std::length_error）
+********************************************/
+
+class CustomerBatch
+{
+private:
+    struct Span {
+        std::uint32_t offset;
+        std::uint32_t len;
+    };
+    std::string arena;
+    std::vector<Span> firsts;
+    std::vector<Span> lasts;
+    std::vector<long> vals;
+
+    Span store(std::string_view s) {
+        if (s.size() > std::numeric_limits<std::uint32_t>::max() - arena.size()) {
+            throw std::length_error{"CustomerBatch: names exceed 4GiB"};
+        }
+        Span sp{static_cast<std::uint32_t>(arena.size()), static_cast<std::uint32_t>(s.size())};
+        arena += s;
+        return sp;
+    }
+    std::string_view view(Span sp) const {
+        return std::string_view{arena.data() + sp.offset, sp.len};
+    }
+public:
+    // 代理对象，Batch是CustomerBatch或者const CustomerBatch：
+    template<typename Batch>
+    class Ref {
+    private:
+        Batch* batch;
+        std::size_t idx;
+    public:
+        Ref(Batch* b, std::size_t i) : batch{b}, idx{i} {
+        }
+        std::string_view firstname() const {
+            return batch->view(batch->firsts[idx]);
+        }
+        std::string_view lastname() const {
+            return batch->view(batch->lasts[idx]);
+        }
+        // 非const的batch返回long&，const的batch返回const long&：
+        auto& value() const {
+            return batch->vals[idx];
+        }
+    };
+
+    template<typename Batch>
+    class Iterator {
+    private:
+        Batch* batch;
+        std::size_t idx;
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Ref<Batch>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Ref<Batch>;   // 按值返回代理
+
+        Iterator(Batch* b, std::size_t i) : batch{b}, idx{i} {
+        }
+        Ref<Batch> operator*() const {
+            return Ref<Batch>{batch, idx};
+        }
+        Ref<Batch> operator[] (difference_type n) const {
+            return Ref<Batch>{batch, idx + n};
+        }
+        Iterator& operator++() {
+            ++idx;
+            return *this;
+        }
+        Iterator operator++(int) {
+            return Iterator{batch, idx++};
+        }
+        Iterator& operator--() {
+            --idx;
+            return *this;
+        }
+        Iterator operator--(int) {
+            return Iterator{batch, idx--};
+        }
+        Iterator& operator+= (difference_type n) {
+            idx += n;
+            return *this;
+        }
+        Iterator& operator-= (difference_type n) {
+            idx -= n;
+            return *this;
+        }
+        friend Iterator operator+ (Iterator it, difference_type n) {
+            return it += n;
+        }
+        friend Iterator operator+ (difference_type n, Iterator it) {
+            return it += n;
+        }
+        friend Iterator operator- (Iterator it, difference_type n) {
+            return it -= n;
+        }
+        friend difference_type operator- (const Iterator& a, const Iterator& b) {
+            return static_cast<difference_type>(a.idx) - static_cast<difference_type>(b.idx);
+        }
+        bool operator== (const Iterator& other) const {
+            return idx == other.idx;
+        }
+        bool operator!= (const Iterator& other) const {
+            return idx != other.idx;
+        }
+        bool operator< (const Iterator& other) const {
+            return idx < other.idx;
+        }
+        bool operator> (const Iterator& other) const {
+            return idx > other.idx;
+        }
+        bool operator<= (const Iterator& other) const {
+            return idx <= other.idx;
+        }
+        bool operator>= (const Iterator& other) const {
+            return idx >= other.idx;
+        }
+    };
+
+    using reference = Ref<CustomerBatch>;
+    using const_reference = Ref<const CustomerBatch>;
+    using iterator = Iterator<CustomerBatch>;
+    using const_iterator = Iterator<const CustomerBatch>;
+
+    // numChars是预计所有名字的总长度：
+    void reserve(std::size_t num, std::size_t numChars = 0) {
+        firsts.reserve(num);
+        lasts.reserve(num);
+        vals.reserve(num);
+        arena.reserve(numChars);
+    }
+
+    void push_back(std::string_view f, std::string_view l, long v) {
+        Span fs = store(f);     // 先存储两个名字，抛出异常时所有的列都没有变化
+        Span ls = store(l);
+        firsts.push_back(fs);
+        lasts.push_back(ls);
+        vals.push_back(v);
+    }
+
+    std::size_t size() const {
+        return vals.size();
+    }
+    bool empty() const {
+        return vals.empty();
+    }
+
+    reference operator[] (std::size_t i) {
+        return reference{this, i};
+    }
+    const_reference operator[] (std::size_t i) const {
+        return const_reference{this, i};
+    }
+
+    iterator begin() {
+        return iterator{this, 0};
+    }
+    iterator end() {
+        return iterator{this, size()};
+    }
+    const_iterator begin() const {
+        return const_iterator{this, 0};
+    }
+    const_iterator end() const {
+        return const_iterator{this, size()};
+    }
+
+    // 列投影：只访问value列
+    const std::vector<long>& values() const {
+        return vals;
+    }
+    std::vector<long>& values() {
+        return vals;
+    }
+    long sumValues() const {
+        return std::accumulate(vals.begin(), vals.end(), 0L);
+    }
+};
+
+// 为代理对象提供tuple-like API来支持结构化绑定：
+template<typename Batch>
+struct std::tuple_size<CustomerBatch::Ref<Batch>> {
+    static constexpr int value = 3;
+};
+
+template<typename Batch>
+struct std::tuple_element<2, CustomerBatch::Ref<Batch>> {
+    using type = std::conditional_t<std::is_const_v<Batch>, const long&, long&>;
+};
+template<std::size_t Idx, typename Batch>
+struct std::tuple_element<Idx, CustomerBatch::Ref<Batch>> {
+    using type = std::string_view;
+};
+
+template<std::size_t I, typename Batch>
+decltype(auto) get(const CustomerBatch::Ref<Batch>& c) {
+    static_assert(I < 3);
+    if constexpr (I == 0) {
+        return c.firstname();
+    }
+    else if constexpr (I == 1) {
+        return c.lastname();
+    }
+    else {  // I == 2
+        return c.value();
+    }
+}
+
+#endif  // CUSTOMERBATCH_HPP
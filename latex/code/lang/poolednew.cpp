@@ -0,0 +1,124 @@
+#include "tracknew.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <cstdint>      // for std::uintptr_t
+#include <cstdlib>      // for std::atoi()
+#include "poolednew.hpp"
+
+// 和alignednew.hpp中的MyType32相同，但是使用内存池：
+struct alignas(32) MyType32 : PooledNew<MyType32> {
+    int i;
+    char c;
+    std::string s[4];
+};
+
+// 使用全局new的版本：
+struct alignas(32) PlainType32 {
+    int i;
+    char c;
+    std::string s[4];
+};
+
+template<typename T>
+bool isAligned(const T* p)
+{
+    return reinterpret_cast<std::uintptr_t>(p) % alignof(T) == 0;
+}
+
+// 维持window个存活的对象，随机替换其中的一个：
+template<typename T>
+bool churn(int window, int num)
+{
+    std::vector<T*> live(window, nullptr);
+    std::mt19937 eng{42};
+    std::uniform_int_distribution<int> dist{0, window - 1};
+    bool ok = true;
+    for (int n = 0; n < num; ++n) {
+        auto& slot = live[dist(eng)];
+        if (slot != nullptr) {
+            ok = ok && slot->i == static_cast<int>(&slot - live.data());
+            delete slot;
+        }
+        slot = new T;
+        slot->i = static_cast<int>(&slot - live.data());
+        ok = ok && isAligned(slot);
+    }
+    for (auto p : live) {
+        delete p;
+    }
+    return ok;
+}
+
+template<typename F>
+void measure(const char* name, F f)
+{
+    TrackNew::reset();
+    auto start = std::chrono::steady_clock::now();
+    bool ok = f();
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    std::cout << name << diff.count() << "ms" << (ok ? "" : " (ERROR)") << ", ";
+    TrackNew::status();
+}
+
+// 一个线程分配，另一个线程释放，然后分配的线程应该重用这些内存：
+bool freeInOtherThread(int num)
+{
+    std::vector<MyType32*> objs(num);
+    for (auto& p : objs) {
+        p = new MyType32;
+        p->c = 'x';
+    }
+    bool ok = true;
+    std::thread other{[&] {
+        for (auto p : objs) {
+            ok = ok && p->c == 'x';
+            delete p;   // 攒成一批之后还给分配的线程
+        }
+        poolalloc::flushRemoteFrees();
+    }};
+    other.join();
+    std::vector<MyType32*> old = objs;
+    std::sort(old.begin(), old.end());
+    for (auto& p : objs) {
+        p = new MyType32;   // 应该重用被归还的内存
+        ok = ok && std::binary_search(old.begin(), old.end(), p);
+    }
+    for (auto p : objs) {
+        delete p;
+    }
+    return ok;
+}
+
+int main(int argc, char* argv[])
+{
+    int num = argc > 1 ? std::atoi(argv[1]) : 10'000'000;
+    int window = argc > 2 ? std::atoi(argv[2]) : 10'000;
+
+    // 单个对象和小数组（包括数组的cookie）都使用内存池，
+    // 每个大小类只在第一次使用时分配一个块，所以先各分配一次：
+    delete new MyType32;
+    delete[] new MyType32[1];
+    TrackNew::reset();
+    auto p = new MyType32;
+    auto arr = new MyType32[1];     // 160字节加上32字节的cookie
+    std::cout << "object and array of 1 from the pool: ";
+    TrackNew::status();             // 0 allocations
+    auto big = new MyType32[5];     // 5*160字节加上cookie超过256字节，使用全局的new
+    std::cout << "array of 5 from global new: ";
+    TrackNew::status();             // 1 allocation
+    std::cout << "aligned: " << std::boolalpha
+              << (isAligned(p) && isAligned(arr) && isAligned(big)) << '\n';
+    delete p;
+    delete[] arr;
+    delete[] big;
+
+    measure("global new: ", [&] { return churn<PlainType32>(window, num); });
+    measure("pooled new: ", [&] { return churn<MyType32>(window, num); });
+    measure("pooled new, freed by another thread: ",
+            [&] { return freeInOtherThread(num / 10); });
+}
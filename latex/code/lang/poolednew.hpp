@@ -0,0 +1,253 @@
+#ifndef POOLEDNEW_HPP
+#define POOLEDNEW_HPP
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uintptr_t
+#include <new>          // for std::align_val_t
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <type_traits>
+
+/********************************************
+* PooledNew<Derived>：和alignednew.hpp中MyType32的operator new/delete一样是类专属的，
+* 但是小对象不再交给全局的堆，而是从当前线程的内存池中分配：
+* - 每16字节一个大小类（最大256字节），每个大小类使用独占的64KB块
+* - 块按照64KB对齐，所以释放时可以通过地址找到块头，从而找到所属的线程和大小类
+* - 其他线程释放的对象先在本线程中攒成一批，再用一次CAS还给所属的线程；
+*   所属的线程在自己的空闲链表为空时一次取回所有被归还的对象
+* - 线程结束后它的内存池会被之后创建的线程接管，块从不归还给全局的堆
+* 超过256字节或者对齐超过256字节的请求仍然交给全局的operator new
+* 用法：struct alignas(32) MyType32 : PooledNew<MyType32> { ... };
+********************************************/
+
+namespace poolalloc {
+
+    inline constexpr std::size_t granularity = 16;
+    inline constexpr std::size_t maxSize = 256;
+    inline constexpr std::size_t numClasses = maxSize / granularity;
+    inline constexpr std::size_t maxAlign = 256;
+    inline constexpr std::size_t chunkSize = 64 * 1024;
+    inline constexpr std::size_t headerSize = maxAlign;    // 块中的第一个对象也满足maxAlign对齐
+    inline constexpr int batchSize = 32;                    // 跨线程归还的批量大小
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Heap;
+
+    struct ChunkHeader {
+        Heap* owner;
+        std::size_t sizeClass;
+    };
+
+    inline ChunkHeader* headerOf(void* p) {
+        return reinterpret_cast<ChunkHeader*>(
+                   reinterpret_cast<std::uintptr_t>(p) & ~(chunkSize - 1));
+    }
+
+    // 不需要内存池时返回numClasses：
+    inline std::size_t sizeClassOf(std::size_t size, std::size_t align) {
+        std::size_t unit = align > granularity ? align : granularity;
+        if (align > maxAlign || size > maxSize) {
+            return numClasses;
+        }
+        // 大小向上取整到对齐的整数倍，所以对象的大小（和块内的偏移）总是对齐的整数倍：
+        std::size_t rounded = (size + unit - 1) / unit * unit;
+        return rounded > maxSize ? numClasses : rounded / granularity - 1;
+    }
+
+    struct Heap {
+        FreeBlock* freeList[numClasses] = {};
+        char* next[numClasses] = {};    // 当前块中还没有用过的部分
+        char* end[numClasses] = {};
+        std::atomic<FreeBlock*> remote{nullptr};    // 其他线程归还的对象
+
+        // 取回其他线程归还的对象：
+        bool drainRemote() {
+            FreeBlock* b = remote.exchange(nullptr, std::memory_order_acquire);
+            if (b == nullptr) {
+                return false;
+            }
+            while (b != nullptr) {
+                FreeBlock* nextBlock = b->next;
+                auto cls = headerOf(b)->sizeClass;
+                b->next = freeList[cls];
+                freeList[cls] = b;
+                b = nextBlock;
+            }
+            return true;
+        }
+
+        void* allocate(std::size_t cls) {
+            if (freeList[cls] == nullptr) {
+                drainRemote();
+            }
+            if (FreeBlock* b = freeList[cls]; b != nullptr) {
+                freeList[cls] = b->next;
+                return b;
+            }
+            std::size_t size = (cls + 1) * granularity;
+            if (next[cls] == nullptr || static_cast<std::size_t>(end[cls] - next[cls]) < size) {
+                // 分配一个新的块：
+                char* chunk = static_cast<char*>(::operator new(chunkSize,
+                                                                std::align_val_t{chunkSize}));
+                ::new (static_cast<void*>(chunk)) ChunkHeader{this, cls};
+                next[cls] = chunk + headerSize;
+                end[cls] = chunk + chunkSize;
+            }
+            void* p = next[cls];
+            next[cls] += size;
+            return p;
+        }
+
+        void deallocateLocal(void* p, std::size_t cls) {
+            auto b = static_cast<FreeBlock*>(p);
+            b->next = freeList[cls];
+            freeList[cls] = b;
+        }
+
+        // 把一串对象（first到last）一次归还给这个内存池：
+        void pushRemote(FreeBlock* first, FreeBlock* last) {
+            FreeBlock* old = remote.load(std::memory_order_relaxed);
+            do {
+                last->next = old;
+            } while (!remote.compare_exchange_weak(old, first,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed));
+        }
+    };
+
+    // 已经结束的线程留下的内存池：
+    inline std::mutex abandonedMx;
+    inline std::vector<Heap*> abandoned;
+
+    // 要还给其他线程的对象：
+    struct RemoteBatch {
+        Heap* owner = nullptr;
+        FreeBlock* first = nullptr;
+        FreeBlock* last = nullptr;
+        int num = 0;
+
+        void flush() {
+            if (num > 0) {
+                owner->pushRemote(first, last);
+                owner = nullptr;
+                first = last = nullptr;
+                num = 0;
+            }
+        }
+        void add(Heap* h, void* p) {
+            if (h != owner) {
+                flush();
+                owner = h;
+            }
+            auto b = static_cast<FreeBlock*>(p);
+            b->next = first;
+            first = b;
+            if (last == nullptr) {
+                last = b;
+            }
+            if (++num == batchSize) {
+                flush();
+            }
+        }
+    };
+
+    struct ThreadState {
+        Heap* heap = nullptr;
+        RemoteBatch batch;
+
+        Heap& get() {
+            if (heap == nullptr) {
+                std::lock_guard lg{abandonedMx};
+                if (!abandoned.empty()) {
+                    heap = abandoned.back();
+                    abandoned.pop_back();
+                }
+                else {
+                    heap = new Heap;    // 从不释放
+                }
+            }
+            return *heap;
+        }
+        ~ThreadState() {
+            batch.flush();
+            if (heap != nullptr) {
+                std::lock_guard lg{abandonedMx};
+                abandoned.push_back(heap);
+            }
+        }
+    };
+
+    inline ThreadState& threadState() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    inline void* allocate(std::size_t size, std::size_t align) {
+        auto cls = sizeClassOf(size, align);
+        if (cls == numClasses) {
+            return ::operator new(size, std::align_val_t{align});
+        }
+        return threadState().get().allocate(cls);
+    }
+
+    inline void deallocate(void* p, std::size_t size, std::size_t align) {
+        if (p == nullptr) {
+            return;
+        }
+        if (sizeClassOf(size, align) == numClasses) {
+            ::operator delete(p, std::align_val_t{align});
+            return;
+        }
+        ThreadState& ts = threadState();
+        ChunkHeader* h = headerOf(p);
+        if (h->owner == &ts.get()) {
+            ts.heap->deallocateLocal(p, h->sizeClass);
+        }
+        else {
+            ts.batch.add(h->owner, p);
+        }
+    }
+
+    // 把当前线程攒下的对象立即还给所属的线程：
+    inline void flushRemoteFrees() {
+        threadState().batch.flush();
+    }
+}
+
+template<typename Derived>
+class PooledNew
+{
+public:
+    static void* operator new (std::size_t size) {
+        return poolalloc::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+    static void* operator new (std::size_t size, std::align_val_t align) {
+        return poolalloc::allocate(size, static_cast<std::size_t>(align));
+    }
+    static void* operator new[] (std::size_t size) {
+        return poolalloc::allocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+    static void* operator new[] (std::size_t size, std::align_val_t align) {
+        return poolalloc::allocate(size, static_cast<std::size_t>(align));
+    }
+
+    // 只提供有大小的版本，这样delete总会传递分配时的大小：
+    static void operator delete (void* p, std::size_t size) {
+        poolalloc::deallocate(p, size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+    static void operator delete (void* p, std::size_t size, std::align_val_t align) {
+        poolalloc::deallocate(p, size, static_cast<std::size_t>(align));
+    }
+    static void operator delete[] (void* p, std::size_t size) {
+        poolalloc::deallocate(p, size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+    }
+    static void operator delete[] (void* p, std::size_t size, std::align_val_t align) {
+        poolalloc::deallocate(p, size, static_cast<std::size_t>(align));
+    }
+};
+
+#endif  // POOLEDNEW_HPP
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>      // for std::atoi()
+#include "taskpool.hpp"
+
+using namespace std::literals;
+
+class Data {
+private:
+    // 不可变的快照：拷贝*this只需要拷贝一个指针，而不是整个字符串
+    std::shared_ptr<const std::string> name;
+public:
+    Data(std::string s) : name{std::make_shared<const std::string>(std::move(s))} {
+    }
+    // 和lambdathis.cpp中的startThreadWithCopyOfThis()相同，但是使用线程池，
+    // 并且可以被取消：
+    auto startTaskWithCopyOfThis(TaskPool& pool) const {
+        return pool.submit([*this] (const CancelToken& token) {
+            if (token.sleepFor(3s)) {
+                std::cout << *name << '\n';
+                return true;
+            }
+            return false;   // 在3秒之内被取消
+        });
+    }
+};
+
+using Clock = std::chrono::steady_clock;
+
+double usSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>{Clock::now() - start}.count();
+}
+
+int main(int argc, char* argv[])
+{
+    int num = argc > 1 ? std::atoi(argv[1]) : 100'000;
+    TaskPool pool{4};
+
+    // 等价于lambdathis.cpp，但是不需要等待3秒：
+    Task<bool> t;
+    {
+        Data d{"c1"};
+        t = d.startTaskWithCopyOfThis(pool);
+    }   // d不再有效
+    t.cancel();
+    try {
+        bool printed = t.get();
+        std::cout << "printed: " << std::boolalpha << printed << '\n';
+    }
+    catch (const TaskCancelled& e) {    // 在开始运行之前就被取消
+        std::cout << "printed: false (" << e.what() << ")\n";
+    }
+
+    // 参数被移动进任务，结果可以继续传给后续任务：
+    auto len = pool.submit([] (std::unique_ptr<std::string> s) { return s->size(); },
+                           std::make_unique<std::string>("moved, not copied"))
+                   .then([] (std::size_t n) { return n * 2; });
+    std::cout << "then(): " << len.get() << '\n';
+
+    // then()消耗第一个任务，所以后续任务可以把结果移走：
+    auto first = pool.submit([] {
+                                 return std::make_unique<std::string>("owned by continuation");
+                             });
+    auto owner = std::move(first).then([] (std::unique_ptr<std::string>& p) {
+                                           return std::move(p);
+                                       });
+    std::cout << "then() moved: " << *owner.get() << ", first.valid(): " << std::boolalpha
+              << first.valid() << '\n';
+
+    // 超时：
+    auto start = Clock::now();
+    auto slow = pool.submitFor(50ms, [] (const CancelToken& token) {
+        token.sleepFor(3s);
+        if (token.cancelled()) {
+            throw TaskCancelled{"gave up"};
+        }
+        return 42;
+    });
+    try {
+        slow.get();
+    }
+    catch (const TaskCancelled& e) {
+        std::cout << "timeout: " << e.what() << " after " << usSince(start) / 1000 << "ms\n";
+    }
+
+    // 还没有开始就被取消的任务不会运行：
+    std::vector<Task<void>> blockers;
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        blockers.push_back(pool.submit([] (const CancelToken& token) {
+            token.sleepFor(100ms);
+        }));
+    }
+    std::atomic<bool> ran{false};
+    auto never = pool.submit([&] { ran = true; });
+    never.cancel();
+    try {
+        never.get();
+    }
+    catch (const TaskCancelled& e) {
+        std::cout << "cancelled: " << e.what() << ", ran: " << ran << '\n';
+    }
+    for (auto& b : blockers) {
+        b.cancel();
+    }
+
+    // 从提交到开始运行的延迟：
+    double poolLatency = 0, threadLatency = 0;
+    int latencyRuns = 1000;
+    for (int i = 0; i < latencyRuns; ++i) {
+        auto s = Clock::now();
+        poolLatency += pool.submit([s] { return usSince(s); }).get();
+    }
+    for (int i = 0; i < latencyRuns; ++i) {
+        double us;
+        auto s = Clock::now();
+        std::thread th{[&us, s] { us = usSince(s); }};
+        th.join();
+        threadLatency += us;
+    }
+    std::cout << "start latency: pool " << poolLatency / latencyRuns << "us, std::thread "
+              << threadLatency / latencyRuns << "us\n";
+
+    // 吞吐量：
+    std::atomic<long> sum{0};
+    start = Clock::now();
+    {
+        std::vector<Task<void>> tasks;
+        tasks.reserve(num);
+        for (int i = 0; i < num; ++i) {
+            tasks.push_back(pool.submit([&sum, i] { sum += i; }));
+        }
+        for (auto& task : tasks) {
+            task.get();
+        }
+    }
+    double poolUs = usSince(start);
+    start = Clock::now();
+    {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num; ++i) {
+            threads.emplace_back([&sum, i] { sum += i; });
+            if (threads.size() == 64) {     // 避免同时存在过多的线程
+                for (auto& th : threads) {
+                    th.join();
+                }
+                threads.clear();
+            }
+        }
+        for (auto& th : threads) {
+            th.join();
+        }
+    }
+    double threadUs = usSince(start);
+    std::cout << num << " tasks: pool " << poolUs / 1000 << "ms, std::thread "
+              << threadUs / 1000 << "ms (sum " << sum << ")\n";
+}
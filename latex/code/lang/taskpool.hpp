@@ -0,0 +1,350 @@
+#ifndef TASKPOOL_HPP
+#define TASKPOOL_HPP
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <memory>       // for std::shared_ptr, std::unique_ptr
+#include <optional>
+#include <variant>      // for std::monostate
+#include <tuple>
+#include <functional>   // for std::invoke()
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>      // for std::move(), std::forward()
+
+/********************************************
+* TaskPool：和lambdathis.cpp中的startThreadWithCopyOfThis()不同，
+* 任务在固定数量的工作线程中运行，而不是每个任务创建一个新线程：
+* - submit(f, args...)把f和参数移动进任务（不会拷贝），返回Task<R>
+* - Task<R>：get()/wait()/waitFor()获取结果，then(f)注册后续任务，cancel()取消任务
+*   then()会消耗这个Task（只能对右值调用），之后结果只属于后续任务，不能再调用get()
+* - submitFor(timeout, f, args...)：超过时间限制之后任务视为已取消
+* - 如果f的第一个参数是const CancelToken&，任务可以在运行时检查是否已被取消，
+*   并用token.sleepFor()代替sleep_for()（取消或者超时时立即返回false）
+* 还没有开始运行就被取消（或者超时）的任务不会再运行，get()会抛出TaskCancelled
+* 注意：TaskPool必须比它的所有Task存活得更久；析构时会运行完队列中剩余的任务
+********************************************/
+
+class TaskCancelled : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class TaskPool;
+
+namespace taskpool_detail {
+
+    struct Job {
+        virtual ~Job() = default;
+        virtual void run() = 0;
+    };
+
+    struct CancelState {
+        std::mutex mx;
+        std::condition_variable cv;
+        std::atomic<bool> cancelFlag{false};
+        std::chrono::steady_clock::time_point deadline
+            = std::chrono::steady_clock::time_point::max();
+
+        bool timedOut() const {
+            return deadline != std::chrono::steady_clock::time_point::max()
+                   && std::chrono::steady_clock::now() >= deadline;
+        }
+        bool cancelled() const {
+            return cancelFlag.load(std::memory_order_relaxed) || timedOut();
+        }
+        void cancel() {
+            {
+                std::lock_guard lg{mx};
+                cancelFlag = true;
+            }
+            cv.notify_all();
+        }
+    };
+}
+
+class CancelToken
+{
+private:
+    std::shared_ptr<taskpool_detail::CancelState> st;
+public:
+    explicit CancelToken(std::shared_ptr<taskpool_detail::CancelState> s)
+     : st{std::move(s)} {
+    }
+    bool cancelled() const {
+        return st->cancelled();
+    }
+    // 等待d，取消或者超时时提前返回false：
+    template<typename Rep, typename Period>
+    bool sleepFor(std::chrono::duration<Rep, Period> d) const {
+        auto until = std::chrono::steady_clock::now() + d;
+        if (until > st->deadline) {
+            until = st->deadline;
+        }
+        std::unique_lock lk{st->mx};
+        st->cv.wait_until(lk, until, [&] { return st->cancelFlag.load(); });
+        return !st->cancelled();
+    }
+};
+
+class TaskPool
+{
+private:
+    std::mutex mx;
+    std::condition_variable cv;
+    std::deque<std::unique_ptr<taskpool_detail::Job>> queue;
+    bool done = false;
+    std::vector<std::thread> workers;
+
+    void workerLoop() {
+        for (;;) {
+            std::unique_ptr<taskpool_detail::Job> job;
+            {
+                std::unique_lock lk{mx};
+                cv.wait(lk, [this] { return done || !queue.empty(); });
+                if (queue.empty()) {
+                    return;     // done并且没有剩余的任务
+                }
+                job = std::move(queue.front());
+                queue.pop_front();
+            }
+            job->run();
+        }
+    }
+public:
+    explicit TaskPool(unsigned numThreads = std::thread::hardware_concurrency()) {
+        if (numThreads == 0) {
+            numThreads = 1;
+        }
+        for (unsigned i = 0; i < numThreads; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+    ~TaskPool() {
+        {
+            std::lock_guard lg{mx};
+            done = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) {
+            t.join();
+        }
+    }
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator= (const TaskPool&) = delete;
+
+    std::size_t size() const {
+        return workers.size();
+    }
+
+    void enqueue(std::unique_ptr<taskpool_detail::Job> job) {
+        {
+            std::lock_guard lg{mx};
+            queue.push_back(std::move(job));
+        }
+        cv.notify_one();
+    }
+
+    template<typename F, typename... Args>
+    auto submitUntil(std::chrono::steady_clock::time_point deadline, F&& f, Args&&... args);
+
+    template<typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) {
+        return submitUntil(std::chrono::steady_clock::time_point::max(),
+                           std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    template<typename Rep, typename Period, typename F, typename... Args>
+    auto submitFor(std::chrono::duration<Rep, Period> timeout, F&& f, Args&&... args) {
+        auto deadline = std::chrono::steady_clock::now()
+                        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+        return submitUntil(deadline, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+};
+
+namespace taskpool_detail {
+
+    template<typename R>
+    struct TaskState : CancelState {
+        using Value = std::conditional_t<std::is_void_v<R>, std::monostate, R>;
+
+        TaskPool* pool;
+        bool ready = false;
+        std::optional<Value> value;
+        std::exception_ptr error;
+        std::vector<std::unique_ptr<Job>> continuations;
+
+        explicit TaskState(TaskPool* p) : pool{p} {
+        }
+
+        void finish(std::optional<Value> v, std::exception_ptr e) {
+            std::vector<std::unique_ptr<Job>> next;
+            {
+                std::lock_guard lg{mx};
+                value = std::move(v);
+                error = e;
+                ready = true;
+                next.swap(continuations);
+            }
+            cv.notify_all();
+            for (auto& j : next) {
+                pool->enqueue(std::move(j));
+            }
+        }
+
+        void addContinuation(std::unique_ptr<Job> j) {
+            {
+                std::lock_guard lg{mx};
+                if (!ready) {
+                    continuations.push_back(std::move(j));
+                    return;
+                }
+            }
+            pool->enqueue(std::move(j));
+        }
+    };
+
+    // 运行call并把结果存入st：
+    template<typename R, typename Call>
+    class CallJob : public Job {
+    private:
+        std::shared_ptr<TaskState<R>> st;
+        Call call;
+    public:
+        CallJob(std::shared_ptr<TaskState<R>> s, Call c)
+         : st{std::move(s)}, call{std::move(c)} {
+        }
+        void run() override {
+            if (st->cancelled()) {
+                st->finish(std::nullopt, std::make_exception_ptr(TaskCancelled{
+                               st->cancelFlag ? "task cancelled" : "task timed out"}));
+                return;
+            }
+            CancelToken token{st};
+            try {
+                if constexpr (std::is_void_v<R>) {
+                    call(token);
+                    st->finish(std::monostate{}, nullptr);
+                }
+                else {
+                    st->finish(call(token), nullptr);
+                }
+            }
+            catch (...) {
+                st->finish(std::nullopt, std::current_exception());
+            }
+        }
+    };
+}
+
+template<typename R>
+class Task
+{
+private:
+    std::shared_ptr<taskpool_detail::TaskState<R>> st;
+public:
+    Task() = default;
+    explicit Task(std::shared_ptr<taskpool_detail::TaskState<R>> s) : st{std::move(s)} {
+    }
+
+    bool valid() const {
+        return st != nullptr;
+    }
+    bool ready() const {
+        std::lock_guard lg{st->mx};
+        return st->ready;
+    }
+    void wait() const {
+        std::unique_lock lk{st->mx};
+        st->cv.wait(lk, [this] { return st->ready; });
+    }
+    // 结果是否在d之内就绪：
+    template<typename Rep, typename Period>
+    bool waitFor(std::chrono::duration<Rep, Period> d) const {
+        std::unique_lock lk{st->mx};
+        return st->cv.wait_for(lk, d, [this] { return st->ready; });
+    }
+    void cancel() {
+        st->cancel();
+    }
+
+    // 和std::future::get()一样只能调用一次（结果被移出）：
+    R get() {
+        wait();
+        if (st->error) {
+            std::rethrow_exception(st->error);
+        }
+        if constexpr (!std::is_void_v<R>) {
+            return std::move(*st->value);
+        }
+    }
+
+    // 这个任务完成后在同一个线程池中运行f(result)（R为void时运行f()），
+    // 如果这个任务抛出异常，返回的任务抛出相同的异常
+    // 结果只交给f（f可以把它移走），所以之后这个Task变为无效（valid()返回false）：
+    template<typename F>
+    auto then(F f) && {
+        using Value = typename taskpool_detail::TaskState<R>::Value;
+        using R2 = typename std::conditional_t<std::is_void_v<R>,
+                                               std::invoke_result<F&>,
+                                               std::invoke_result<F&, Value&>>::type;
+        using Result = std::conditional_t<std::is_void_v<R2>, void, std::decay_t<R2>>;
+        auto prev = std::move(st);
+        auto next = std::make_shared<taskpool_detail::TaskState<Result>>(prev->pool);
+        auto call = [prev, f = std::move(f)] (const CancelToken&) mutable -> Result {
+            if (prev->error) {
+                std::rethrow_exception(prev->error);
+            }
+            if constexpr (std::is_void_v<R>) {
+                return f();
+            }
+            else {
+                return f(*prev->value);
+            }
+        };
+        prev->addContinuation(
+            std::make_unique<taskpool_detail::CallJob<Result, decltype(call)>>(next,
+                                                                              std::move(call)));
+        return Task<Result>{next};
+    }
+};
+
+template<typename F, typename... Args>
+auto TaskPool::submitUntil(std::chrono::steady_clock::time_point deadline,
+                           F&& f, Args&&... args)
+{
+    using Fn = std::decay_t<F>;
+    constexpr bool takesToken = std::is_invocable_v<Fn&, const CancelToken&,
+                                                    std::decay_t<Args>...>;
+    using R = typename std::conditional_t<takesToken,
+                           std::invoke_result<Fn&, const CancelToken&, std::decay_t<Args>...>,
+                           std::invoke_result<Fn&, std::decay_t<Args>...>>::type;
+    using Result = std::conditional_t<std::is_void_v<R>, void, std::decay_t<R>>;
+
+    // f和参数都被移动（或者转发）进任务：
+    auto call = [f = std::forward<F>(f),
+                 args = std::make_tuple(std::forward<Args>(args)...)]
+                (const CancelToken& token) mutable -> Result {
+        return std::apply([&] (auto&... a) -> Result {
+                              if constexpr (takesToken) {
+                                  return std::invoke(f, token, std::move(a)...);
+                              }
+                              else {
+                                  return std::invoke(f, std::move(a)...);
+                              }
+                          }, args);
+    };
+    auto st = std::make_shared<taskpool_detail::TaskState<Result>>(this);
+    st->deadline = deadline;    // 在任务入队之前设置，所以不需要同步
+    enqueue(std::make_unique<taskpool_detail::CallJob<Result, decltype(call)>>(st,
+                                                                              std::move(call)));
+    return Task<Result>{st};
+}
+
+#endif  // TASKPOOL_HPP
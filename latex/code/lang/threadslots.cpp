@@ -0,0 +1,112 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <chrono>
+#include <cstdlib>      // for std::atol()
+#include "threadslots.hpp"
+
+#ifdef _MSC_VER
+#define NOINLINE __declspec(noinline)
+#else
+#define NOINLINE __attribute__((noinline))
+#endif
+
+// 和inlinethreadlocal.hpp中的MyData一样有需要动态初始化的成员：
+struct Stats {
+    std::string name = "worker";
+    std::atomic<long> hits{0};  // 可能被控制线程同时读取
+};
+
+// 同一种递增操作的三种实现：
+inline thread_local Stats tlsStats;
+NOINLINE void hitThreadLocal()
+{
+    auto& h = tlsStats.hits;
+    h.store(h.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+NOINLINE void hitThreadSlots()
+{
+    auto& h = ThreadSlots<Stats>::local().hits;
+    h.store(h.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+std::mutex mapMx;
+std::unordered_map<std::thread::id, Stats> mapStats;
+NOINLINE void hitMutexMap()
+{
+    std::lock_guard lg{mapMx};
+    auto& h = mapStats[std::this_thread::get_id()].hits;
+    h.store(h.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+template<typename F>
+double run(int numThreads, long num, F hit)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([=] {
+            for (long i = 0; i < num; ++i) {
+                hit();
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::chrono::duration<double, std::nano> diff{std::chrono::steady_clock::now() - start};
+    return diff.count() / (numThreads * num);
+}
+
+int main(int argc, char* argv[])
+{
+    long num = argc > 1 ? std::atol(argv[1]) : 1'000'000;
+
+    // 结束的线程把计数合并到retired中：
+    long retired = 0;
+    ThreadSlots<Stats>::onThreadExit([&] (Stats& s) {
+        retired += s.hits.load();
+    });
+
+    // 控制线程在工作线程运行时汇总：
+    {
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; ++t) {
+            workers.emplace_back([&] {
+                while (!stop) {
+                    hitThreadSlots();
+                }
+            });
+        }
+        for (int i = 0; i < 3; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            long live = 0;
+            ThreadSlots<Stats>::forEach([&] (const Stats& s) {
+                live += s.hits.load(std::memory_order_relaxed);
+            });
+            std::cout << ThreadSlots<Stats>::size() << " threads, " << live << " hits so far\n";
+        }
+        stop = true;
+        for (auto& t : workers) {
+            t.join();
+        }
+        std::cout << "after join: " << ThreadSlots<Stats>::size() << " threads, "
+                  << retired << " hits retired\n";
+    }
+
+    for (int n = 1; n <= 64; n *= 2) {
+        retired = 0;
+        double t1 = run(n, num, hitThreadLocal);
+        double t2 = run(n, num, hitThreadSlots);
+        double t3 = run(n, num, hitMutexMap);
+        std::cout << n << " threads: thread_local " << t1 << "ns, ThreadSlots " << t2
+                  << "ns, mutex map " << t3 << "ns"
+                  << (retired == n * num ? "\n" : " (ERROR)\n");
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef THREADSLOTS_HPP
+#define THREADSLOTS_HPP
+
+#include <mutex>
+#include <vector>
+#include <algorithm>    // for std::find()
+#include <functional>   // for std::function
+#include <utility>      // for std::move()
+
+/********************************************
+* ThreadSlots<T, Tag>：和inlinethreadlocal.hpp中的myThreadData一样，
+* 每个线程在第一次访问时构造自己的T对象，但是另外：
+* - 控制线程可以通过forEach()遍历所有存活线程的对象（例如汇总统计数据）
+* - 线程结束时先在锁内调用onThreadExit()设置的回调（例如把计数合并到总数中）
+*   并注销该对象，然后再销毁它，所以forEach()永远不会看到已经销毁的对象
+* 快速路径local()和直接访问一个thread_local变量的开销相同；
+* 只有第一次访问和线程结束时需要加锁
+* Tag用于区分相同类型的不同用途
+* 注意：forEach()和其他线程可能同时访问同一个对象，
+*      所以需要被汇总的成员应该使用atomic或者其他同步方式
+********************************************/
+
+template<typename T, typename Tag = T>
+class ThreadSlots
+{
+private:
+    struct Holder {
+        T value{};
+        Holder() {
+            std::lock_guard lg{mx};
+            holders.push_back(this);
+        }
+        ~Holder() {
+            std::lock_guard lg{mx};
+            if (exitHook) {
+                exitHook(value);
+            }
+            holders.erase(std::find(holders.begin(), holders.end(), this));
+        }
+    };
+
+    inline static std::mutex mx;
+    inline static std::vector<Holder*> holders;             // 所有存活线程的对象
+    inline static std::function<void(T&)> exitHook;
+public:
+    // 当前线程的对象：
+    static T& local() {
+        thread_local Holder holder;
+        return holder.value;
+    }
+
+    // 对每一个存活线程的对象调用f（持有锁，所以这期间不会有线程注册或者注销）：
+    template<typename F>
+    static void forEach(F f) {
+        std::lock_guard lg{mx};
+        for (Holder* h : holders) {
+            f(h->value);
+        }
+    }
+
+    static std::size_t size() {
+        std::lock_guard lg{mx};
+        return holders.size();
+    }
+
+    // 线程结束时对它的对象调用f（持有和forEach()相同的锁）：
+    static void onThreadExit(std::function<void(T&)> f) {
+        std::lock_guard lg{mx};
+        exitHook = std::move(f);
+    }
+};
+
+#endif  // THREADSLOTS_HPP
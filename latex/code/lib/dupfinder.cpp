@@ -0,0 +1,130 @@
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <random>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <execution>    // for 执行策略
+#include <filesystem>
+#include <cstdlib>      // for atoi()
+#include "dupfinder.hpp"
+#include "timer.hpp"
+
+namespace fs = std::filesystem;
+
+// 创建numFiles个文件，大小只有几种（所以按大小分组留下很多候选者）：
+// - 每10个文件中有1个是之前某个文件的副本
+// - 另外一些文件和之前的某个文件只有最后一个字节不同（第二个阶段无法区分）
+void createFiles(const fs::path& root, int numFiles)
+{
+    static const std::size_t sizes[] = {100, 4096, 10'000, 100'000, 1'000'000};
+    std::mt19937 eng{7};
+    std::vector<std::string> contents;
+    for (int i = 0; i < numFiles; ++i) {
+        std::string data;
+        if (i >= 10 && i % 10 == 0) {
+            data = contents[eng() % contents.size()];           // 副本
+        }
+        else if (i >= 10 && i % 10 == 5) {
+            data = contents[eng() % contents.size()];
+            data.back() ^= 1;                                   // 几乎相同
+        }
+        else {
+            data.resize(sizes[eng() % 5]);
+            for (auto& c : data) {
+                c = static_cast<char>(eng());
+            }
+        }
+        fs::path dir = root / ("d" + std::to_string(i % 50));
+        create_directories(dir);
+        std::ofstream{dir / ("f" + std::to_string(i)), std::ios::binary} << data;
+        if (contents.size() < 1000) {
+            contents.push_back(std::move(data));
+        }
+    }
+}
+
+// 简单的做法：读取所有文件的全部内容并计算哈希
+std::set<std::set<fs::path>> naiveDuplicates(const fs::path& root, std::uintmax_t& bytesRead)
+{
+    std::vector<dupfinder_detail::Candidate> cands;
+    for (const auto& e : fs::recursive_directory_iterator{root}) {
+        if (e.is_regular_file() && e.file_size() > 0) {
+            cands.push_back(dupfinder_detail::Candidate{e.path(), e.file_size()});
+        }
+    }
+    std::for_each(std::execution::par, cands.begin(), cands.end(),
+                  [] (auto& c) {
+                      dupfinder_detail::hashFile(c.path, c.size, c.size, c.hash);
+                  });
+    std::map<std::pair<std::uintmax_t, std::uint64_t>, std::set<fs::path>> groups;
+    bytesRead = 0;
+    for (const auto& c : cands) {
+        groups[{c.size, c.hash}].insert(c.path);
+        bytesRead += c.size;
+    }
+    std::set<std::set<fs::path>> result;
+    for (auto& [key, paths] : groups) {
+        if (paths.size() > 1) {
+            result.insert(std::move(paths));
+        }
+    }
+    return result;
+}
+
+int main(int argc, char* argv[])
+{
+    fs::path root{argc > 1 ? argv[1] : "tmp/dups"};
+    int numFiles = argc > 2 ? std::atoi(argv[2]) : 20'000;
+    if (!exists(root)) {
+        std::cout << "creating " << numFiles << " files in " << root.string() << '\n';
+        createFiles(root, numFiles);
+    }
+
+    Timer t;
+    auto report = findDuplicates(root);
+    t.printDiff("findDuplicates(): ");
+    std::uintmax_t dupFiles = 0;
+    for (const auto& g : report.groups) {
+        dupFiles += g.paths.size() - 1;
+    }
+    std::cout << "  " << report.files << " files, " << report.totalBytes << " bytes\n"
+              << "  candidates: " << report.afterSize << " after size, " << report.afterHead
+              << " after first 4KiB, " << report.afterFull << " after full hash\n"
+              << "  bytes read: " << report.headBytesRead << " (heads) + " << report.fullBytesRead
+              << " (full), "
+              << (report.headBytesRead + report.fullBytesRead) / std::max<std::uintmax_t>(dupFiles, 1)
+              << " per duplicate found\n"
+              << "  " << report.groups.size() << " groups, " << dupFiles << " duplicates, "
+              << report.reclaimable << " bytes reclaimable, " << report.errors << " errors\n";
+    for (std::size_t i = 0; i < report.groups.size() && i < 3; ++i) {
+        std::cout << "  " << report.groups[i].size << " bytes x " << report.groups[i].paths.size()
+                  << ": " << report.groups[i].paths[0].string() << " ...\n";
+    }
+
+    // 和简单的做法比较：
+    Timer t2;
+    std::uintmax_t naiveBytes = 0;
+    auto expected = naiveDuplicates(root, naiveBytes);
+    t2.printDiff("hashing all files: ");
+    std::cout << "  bytes read: " << naiveBytes << ", "
+              << naiveBytes / std::max<std::uintmax_t>(dupFiles, 1) << " per duplicate found\n";
+    std::set<std::set<fs::path>> found;
+    for (const auto& g : report.groups) {
+        found.emplace(g.paths.begin(), g.paths.end());
+    }
+    std::cout << "same groups as hashing all files: " << (found == expected ? "OK" : "ERROR")
+              << '\n';
+
+    // 遍历之后文件变小（或者变大）时不会访问映射之外的内存，而是报告错误：
+    fs::path changed = root / "changed";
+    std::ofstream{changed, std::ios::binary} << std::string(100, 'x');
+    std::uint64_t h;
+    bool ok = dupfinder_detail::hashFile(changed, 100'000, 100'000, h) < 0
+              && dupfinder_detail::hashFile(changed, 10, 10, h) < 0
+              && dupfinder_detail::hashFile(changed, 100, 4096, h) == 100;
+    remove(changed);
+    std::cout << "size changed after the walk: " << (ok ? "OK" : "ERROR") << '\n';
+}
@@ -0,0 +1,285 @@
+#ifndef DUPFINDER_HPP
+#define DUPFINDER_HPP
+
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <system_error>
+#include <algorithm>    // for sort(), for_each(), remove_if()
+#include <iterator>     // for back_inserter()
+#include <utility>      // for pair
+#include <functional>   // for hash
+#include <limits>
+#include <execution>    // for 执行策略
+#include <atomic>
+#include <unordered_set>
+#include <cstring>      // for memcpy()
+#include <cstdint>
+#include <cstdio>       // for fopen(), fread()
+#ifndef _MSC_VER
+#include <fcntl.h>      // for open()
+#include <unistd.h>     // for close()
+#include <sys/stat.h>   // for stat(), fstat()
+#include <sys/mman.h>   // for mmap()
+#endif
+
+/********************************************
+* findDuplicates(root)：查找内容相同的文件，分为多个阶段，
+* 每个阶段只处理上一个阶段留下的候选者：
+* 1. 遍历目录（和dirsize.cpp一样），按大小分组，大小唯一的文件不可能重复
+*    （同一个文件的多个硬链接只保留一个，空文件被忽略）
+* 2. 并行计算每个候选者前4KiB的哈希值，按（大小，头部哈希）分组
+* 3. 并行计算剩下的候选者的完整哈希值（不超过4KiB的文件不需要再次读取），
+*    按（大小，完整哈希）分组
+* 读取文件时使用mmap()（Windows上使用1MiB缓冲区的fread()），
+* 遍历之后大小发生变化的文件被当作读取失败（计入errors）
+* 哈希是一个64位的非加密哈希（每次处理8个字节），
+* 没有再逐字节比较，所以不同的文件有大约2^-64的概率被当作重复文件
+********************************************/
+
+namespace dupfinder_detail {
+
+    // 每次处理8个字节的流式哈希：
+    class Hasher {
+    private:
+        std::uint64_t h;
+        std::uint64_t tail = 0;     // 还不够8个字节的部分
+        unsigned tailLen = 0;
+        std::uint64_t total = 0;
+
+        static std::uint64_t mix(std::uint64_t h, std::uint64_t w) {
+            h ^= w * 0x9e3779b97f4a7c15ULL;
+            h = (h << 31) | (h >> 33);
+            return h * 0xbf58476d1ce4e5b9ULL;
+        }
+    public:
+        explicit Hasher(std::uint64_t seed = 0) : h{seed ^ 0x94d049bb133111ebULL} {
+        }
+        void update(const char* p, std::size_t n) {
+            total += n;
+            while (tailLen > 0 && tailLen < 8 && n > 0) {
+                tail |= std::uint64_t{static_cast<unsigned char>(*p++)} << (8 * tailLen++);
+                --n;
+            }
+            if (tailLen == 8) {
+                h = mix(h, tail);
+                tail = 0;
+                tailLen = 0;
+            }
+            for (; n >= 8; p += 8, n -= 8) {
+                std::uint64_t w;
+                std::memcpy(&w, p, 8);
+                h = mix(h, w);
+            }
+            for (; n > 0; --n) {
+                tail |= std::uint64_t{static_cast<unsigned char>(*p++)} << (8 * tailLen++);
+            }
+        }
+        std::uint64_t digest() const {
+            std::uint64_t r = mix(mix(h, tail), total);
+            r ^= r >> 29;
+            return r;
+        }
+    };
+
+    // 计算文件前limit个字节的哈希，返回实际读取的字节数（出错时返回-1）
+    // 如果文件的大小已经不是size（遍历之后被修改），也返回-1：
+    inline long long hashFile(const std::filesystem::path& p, std::uintmax_t size,
+                              std::uintmax_t limit, std::uint64_t& hash) {
+        std::uintmax_t n = std::min(size, limit);
+        Hasher hasher;
+#ifndef _MSC_VER
+        int fd = ::open(p.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return -1;
+        }
+        // 只映射打开的文件当前的大小，否则文件变小之后访问映射会导致SIGBUS：
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<std::uintmax_t>(st.st_size) != size) {
+            ::close(fd);
+            return -1;
+        }
+        if (n > 0) {
+            void* m = ::mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m == MAP_FAILED) {
+                ::close(fd);
+                return -1;
+            }
+            ::madvise(m, n, MADV_SEQUENTIAL);
+            hasher.update(static_cast<const char*>(m), n);
+            ::munmap(m, n);
+        }
+        ::close(fd);
+#else
+        std::FILE* f = std::fopen(p.string().c_str(), "rb");
+        if (f == nullptr) {
+            return -1;
+        }
+        std::error_code ec;
+        if (std::filesystem::file_size(p, ec) != size || ec) {
+            std::fclose(f);
+            return -1;
+        }
+        std::vector<char> buf(std::min<std::uintmax_t>(n, 1 << 20));
+        for (std::uintmax_t done = 0; done < n; ) {
+            auto r = std::fread(buf.data(), 1, std::min<std::uintmax_t>(buf.size(), n - done), f);
+            if (r == 0) {
+                std::fclose(f);
+                return -1;
+            }
+            hasher.update(buf.data(), r);
+            done += r;
+        }
+        std::fclose(f);
+#endif
+        hash = hasher.digest();
+        return static_cast<long long>(n);
+    }
+
+    struct Candidate {
+        std::filesystem::path path;
+        std::uintmax_t size;
+        std::uint64_t hash = 0;     // 当前阶段的哈希
+        bool ok = true;             // 读取失败或者大小已经改变时为false
+    };
+
+    // 删除读取失败的候选者，按（大小，哈希）排序，只保留至少有两个元素的组：
+    inline void keepGroups(std::vector<Candidate>& cands) {
+        cands.erase(std::remove_if(cands.begin(), cands.end(),
+                                   [] (const Candidate& c) { return !c.ok; }),
+                    cands.end());
+        auto key = [] (const Candidate& c) { return std::make_pair(c.size, c.hash); };
+        std::sort(cands.begin(), cands.end(),
+                  [&] (const Candidate& a, const Candidate& b) { return key(a) < key(b); });
+        std::vector<Candidate> kept;
+        for (std::size_t i = 0; i < cands.size(); ) {
+            std::size_t j = i;
+            while (j < cands.size() && key(cands[j]) == key(cands[i])) {
+                ++j;
+            }
+            if (j - i >= 2) {
+                std::move(cands.begin() + i, cands.begin() + j, std::back_inserter(kept));
+            }
+            i = j;
+        }
+        cands = std::move(kept);
+    }
+}
+
+struct DuplicateGroup {
+    std::uintmax_t size;                        // 每个文件的大小
+    std::vector<std::filesystem::path> paths;
+    std::uintmax_t reclaimable() const {        // 只保留一个副本时节省的字节数
+        return size * (paths.size() - 1);
+    }
+};
+
+struct DuplicateReport {
+    std::vector<DuplicateGroup> groups;         // 按可节省的字节数降序
+    std::uintmax_t files = 0;                   // 所有普通文件
+    std::uintmax_t totalBytes = 0;
+    std::uintmax_t afterSize = 0;               // 每个阶段之后剩下的候选者
+    std::uintmax_t afterHead = 0;
+    std::uintmax_t afterFull = 0;
+    std::uintmax_t headBytesRead = 0;           // 每个阶段读取的字节数
+    std::uintmax_t fullBytesRead = 0;
+    std::uintmax_t errors = 0;
+    std::uintmax_t reclaimable = 0;
+};
+
+inline DuplicateReport findDuplicates(const std::filesystem::path& root,
+                                      std::uintmax_t headSize = 4096)
+{
+    namespace fs = std::filesystem;
+    using dupfinder_detail::Candidate;
+    DuplicateReport report;
+
+    // 第一步：遍历并按大小分组
+    std::vector<Candidate> cands;
+#ifndef _MSC_VER
+    struct IdHash {
+        std::size_t operator() (const std::pair<dev_t, ino_t>& id) const {
+            return std::hash<std::uint64_t>{}(id.second * 0x9e3779b97f4a7c15ULL ^ id.first);
+        }
+    };
+    std::unordered_set<std::pair<dev_t, ino_t>, IdHash> seen;
+#endif
+    std::error_code ec;
+    for (fs::recursive_directory_iterator pos{root, fs::directory_options::skip_permission_denied,
+                                              ec}, end;
+         !ec && pos != end; pos.increment(ec)) {
+        std::error_code ec2;
+        if (!pos->is_regular_file(ec2) || pos->is_symlink(ec2)) {
+            continue;
+        }
+        auto size = pos->file_size(ec2);
+        if (ec2) {
+            ++report.errors;
+            continue;
+        }
+        ++report.files;
+        report.totalBytes += size;
+#ifndef _MSC_VER
+        struct stat st;
+        if (::stat(pos->path().c_str(), &st) == 0 && st.st_nlink > 1
+            && !seen.emplace(st.st_dev, st.st_ino).second) {
+            continue;   // 已经见过的硬链接
+        }
+#endif
+        if (size > 0) {
+            cands.push_back(Candidate{pos->path(), size});
+        }
+    }
+    if (ec) {
+        ++report.errors;
+    }
+    dupfinder_detail::keepGroups(cands);
+    report.afterSize = cands.size();
+
+    // 第二步和第三步：并行地计算哈希，然后再次分组
+    std::atomic<std::uintmax_t> bytesRead{0}, errors{0};
+    auto hashStage = [&] (std::uintmax_t limit) {
+        bytesRead = 0;
+        std::for_each(std::execution::par, cands.begin(), cands.end(),
+                      [&] (Candidate& c) {
+                          if (limit > headSize && c.size <= headSize) {
+                              return;   // 头部哈希已经是完整的哈希
+                          }
+                          auto n = dupfinder_detail::hashFile(c.path, c.size, limit, c.hash);
+                          if (n < 0) {
+                              c.ok = false;
+                              ++errors;
+                          }
+                          else {
+                              bytesRead += static_cast<std::uintmax_t>(n);
+                          }
+                      });
+        dupfinder_detail::keepGroups(cands);
+        return bytesRead.load();
+    };
+    report.headBytesRead = hashStage(headSize);
+    report.afterHead = cands.size();
+    report.fullBytesRead = hashStage(std::numeric_limits<std::uintmax_t>::max());
+    report.afterFull = cands.size();
+    report.errors += errors;
+
+    // 整理结果：
+    for (std::size_t i = 0; i < cands.size(); ) {
+        DuplicateGroup g{cands[i].size, {}};
+        std::size_t j = i;
+        for (; j < cands.size() && cands[j].size == cands[i].size
+               && cands[j].hash == cands[i].hash; ++j) {
+            g.paths.push_back(std::move(cands[j].path));
+        }
+        report.reclaimable += g.reclaimable();
+        report.groups.push_back(std::move(g));
+        i = j;
+    }
+    std::sort(report.groups.begin(), report.groups.end(),
+              [] (const DuplicateGroup& a, const DuplicateGroup& b) {
+                  return a.reclaimable() > b.reclaimable();
+              });
+    return report;
+}
+
+#endif  // DUPFINDER_HPP
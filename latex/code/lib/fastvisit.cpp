@@ -0,0 +1,107 @@
+#include <iostream>
+#include <string>
+#include <variant>
+#include <vector>
+#include <cstdlib>      // for std::atol()
+#include "fastvisit.hpp"
+#include "../tmpl/overload.hpp"
+#include "timer.hpp"
+
+// 赋值时抛出异常的类型，用来构造valueless的variant：
+struct ThrowOnCopy {
+    ThrowOnCopy() = default;
+    ThrowOnCopy(const ThrowOnCopy&) {
+        throw 42;
+    }
+    ThrowOnCopy& operator= (const ThrowOnCopy&) = default;
+};
+
+void checkSemantics()
+{
+    auto ov = overload {
+                  [] (int i) { return "int:    " + std::to_string(i); },
+                  [] (double d) { return "double: " + std::to_string(d); },
+                  [] (const std::string& s) { return "string: " + s; },
+              };
+
+    std::variant<int, double, std::string> var{42};
+    for (int i = 0; i < 3; ++i) {
+        std::cout << fast_visit(ov, var) << '\n';
+        std::cout << (fast_visit(ov, var) == std::visit(ov, var) ? "  same as std::visit\n"
+                                                                   : "  ERROR\n");
+        var = (i == 0 ? decltype(var){0.5} : decltype(var){"hello"});
+    }
+
+    // 通过引用修改当前的值：
+    fast_visit([] (auto& v) { v += v; }, var);
+    std::cout << "modified: " << std::get<std::string>(var) << '\n';
+
+    // 同时访问多个variant：
+    std::variant<int, double> v1{2}, v2{0.25};
+    auto mult = [] (auto a, auto b) { return static_cast<double>(a * b); };
+    std::cout << "multi: " << fast_visit(mult, v1, v2)
+              << " (std::visit: " << std::visit(mult, v1, v2) << ")\n";
+
+    // valueless的variant：
+    std::variant<int, ThrowOnCopy> vl;
+    try {
+        ThrowOnCopy t;
+        vl.emplace<1>(t);
+    }
+    catch (...) {
+    }
+    std::cout << "valueless: " << std::boolalpha << vl.valueless_by_exception() << '\n';
+    for (auto visit : { +[] (std::variant<int, ThrowOnCopy>& v) {
+                            fast_visit([] (auto&) {}, v);
+                        },
+                        +[] (std::variant<int, ThrowOnCopy>& v) {
+                            std::visit([] (auto&) {}, v);
+                        } }) {
+        try {
+            visit(vl);
+            std::cout << "  ERROR: no exception\n";
+        }
+        catch (const std::bad_variant_access&) {
+            std::cout << "  bad_variant_access thrown\n";
+        }
+    }
+}
+
+// 可以用g++ -O2 -S编译本文件来验证生成的代码：
+// std::visit()通过函数指针表间接调用，fast_visit()则是内联的跳转表
+int main(int argc, char* argv[])
+{
+    checkSemantics();
+
+    long numElems = argc > 1 ? std::atol(argv[1]) : 10'000'000;
+    using Var = std::variant<int, long, float, double>;
+    std::vector<Var> coll;
+    coll.reserve(numElems);
+    for (long i = 0; i < numElems; ++i) {
+        switch (i % 4) {
+            case 0: coll.emplace_back(static_cast<int>(i)); break;
+            case 1: coll.emplace_back(i); break;
+            case 2: coll.emplace_back(static_cast<float>(i)); break;
+            default: coll.emplace_back(static_cast<double>(i)); break;
+        }
+    }
+    auto toDouble = overload {
+                        [] (int i) { return static_cast<double>(i); },
+                        [] (long l) { return static_cast<double>(l); },
+                        [] (float f) { return static_cast<double>(f); },
+                        [] (double d) { return d; },
+                    };
+
+    Timer t;
+    double sum1 = 0;
+    for (const auto& v : coll) {
+        sum1 += std::visit(toDouble, v);
+    }
+    t.printDiff("std::visit():  ");
+    double sum2 = 0;
+    for (const auto& v : coll) {
+        sum2 += fast_visit(toDouble, v);
+    }
+    t.printDiff("fast_visit():  ");
+    std::cout << "sums " << (sum1 == sum2 ? "match" : "DIFFER") << '\n';
+}
@@ -0,0 +1,104 @@
+#ifndef FASTVISIT_HPP
+#define FASTVISIT_HPP
+
+#include <variant>
+#include <utility>      // for std::forward(), std::index_sequence
+#include <functional>   // for std::invoke()
+#include <type_traits>
+
+/********************************************
+* fast_visit()：用switch代替函数指针表的visit
+* - 最多支持FastVisitMaxAlternatives个备选项，
+*   更多的备选项退回到std::visit()
+* - 可以同时访问多个variant
+* - 和std::visit()一样，valueless的variant会抛出std::bad_variant_access
+********************************************/
+
+inline constexpr std::size_t FastVisitMaxAlternatives = 16;
+
+namespace fastvisit_detail {
+
+    // 以和传入的variant相同的值类别访问第I个备选项：
+    template<std::size_t I, typename Variant>
+    constexpr decltype(auto) getAlt(Variant&& var) {
+        return std::get<I>(std::forward<Variant>(var));
+    }
+
+    // 所有备选项都必须返回相同的类型（和std::visit()一样）：
+    template<typename Visitor, typename Variant>
+    using Result = std::invoke_result_t<Visitor,
+                                        decltype(getAlt<0>(std::declval<Variant>()))>;
+
+    template<typename Visitor, typename Variant, std::size_t... Is>
+    constexpr bool sameResults(std::index_sequence<Is...>) {
+        return (std::is_same_v<Result<Visitor, Variant>,
+                               std::invoke_result_t<Visitor,
+                                                    decltype(getAlt<Is>(std::declval<Variant>()))>>
+                && ...);
+    }
+
+    // 如果I是有效的索引就调用visitor（否则这个分支永远不会被执行）：
+    template<std::size_t I, typename Visitor, typename Variant>
+    constexpr Result<Visitor, Variant> visitAt(Visitor&& vis, Variant&& var) {
+        constexpr std::size_t size = std::variant_size_v<std::remove_reference_t<Variant>>;
+        if constexpr (I < size) {
+            return std::invoke(std::forward<Visitor>(vis),
+                               getAlt<I>(std::forward<Variant>(var)));
+        }
+        else {
+            throw std::bad_variant_access{};
+        }
+    }
+
+    template<typename Visitor, typename Variant>
+    constexpr Result<Visitor, Variant> visitOne(Visitor&& vis, Variant&& var) {
+        constexpr std::size_t size = std::variant_size_v<std::remove_reference_t<Variant>>;
+        if constexpr (size > FastVisitMaxAlternatives) {
+            return std::visit(std::forward<Visitor>(vis), std::forward<Variant>(var));
+        }
+        else {
+            static_assert(sameResults<Visitor, Variant>(std::make_index_sequence<size>{}),
+                          "fast_visit() requires all alternatives to return the same type");
+            if (var.valueless_by_exception()) {
+                throw std::bad_variant_access{};
+            }
+            // 每一个case都是直接调用，优化器可以内联visitor：
+#define FASTVISIT_CASE(I) \
+            case I: return visitAt<I>(std::forward<Visitor>(vis), std::forward<Variant>(var));
+            switch (var.index()) {
+                FASTVISIT_CASE(0)  FASTVISIT_CASE(1)  FASTVISIT_CASE(2)  FASTVISIT_CASE(3)
+                FASTVISIT_CASE(4)  FASTVISIT_CASE(5)  FASTVISIT_CASE(6)  FASTVISIT_CASE(7)
+                FASTVISIT_CASE(8)  FASTVISIT_CASE(9)  FASTVISIT_CASE(10) FASTVISIT_CASE(11)
+                FASTVISIT_CASE(12) FASTVISIT_CASE(13) FASTVISIT_CASE(14) FASTVISIT_CASE(15)
+            }
+#undef FASTVISIT_CASE
+            throw std::bad_variant_access{};
+        }
+    }
+}
+
+// 访问单个variant：
+template<typename Visitor, typename Variant>
+constexpr decltype(auto) fast_visit(Visitor&& vis, Variant&& var)
+{
+    return fastvisit_detail::visitOne(std::forward<Visitor>(vis),
+                                      std::forward<Variant>(var));
+}
+
+// 访问多个variant：先展开第一个，再递归地展开剩余的：
+template<typename Visitor, typename Variant, typename... Variants>
+constexpr decltype(auto) fast_visit(Visitor&& vis, Variant&& var, Variants&&... vars)
+{
+    return fastvisit_detail::visitOne(
+             [&] (auto&& alt) -> decltype(auto) {
+                 return fast_visit([&] (auto&&... alts) -> decltype(auto) {
+                                       return std::invoke(std::forward<Visitor>(vis),
+                                                          std::forward<decltype(alt)>(alt),
+                                                          std::forward<decltype(alts)>(alts)...);
+                                   },
+                                   std::forward<Variants>(vars)...);
+             },
+             std::forward<Variant>(var));
+}
+
+#endif  // FASTVISIT_HPP
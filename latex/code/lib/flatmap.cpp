@@ -0,0 +1,165 @@
+#include <iostream>
+#include <string>
+#include <map>
+#include <vector>
+#include <random>
+#include <array>
+#include <stdexcept>
+#include <cstdlib>      // for std::atol()
+#include <memory_resource>
+#include "flatmap.hpp"
+#include "timer.hpp"
+
+template<typename T1, typename T2>
+void print(const T1& coll1, const T2& coll2)
+{
+    std::cout << "values:\n";
+    for (const auto& [key, value] : coll1) {
+        std::cout << "  [" << key << ":" << value << "]";
+    }
+    std::cout << '\n';
+    for (const auto& [key, value] : coll2) {
+        std::cout << "  [" << key << ":" << value << "]";
+    }
+    std::cout << '\n';
+}
+
+// 和nodemerge.cpp相同的操作：
+void demo()
+{
+    flat_multimap<double, std::string> src {{1.1, "one"},
+                                            {2.2, "two"},
+                                            {3.3, "three"}};
+    flat_map<double, std::string> dst {{3.3, "old data"}};
+    print(src, dst);
+    dst.merge(src);
+    print(src, dst);
+
+    // 和节点句柄一样修改键：
+    auto nh = dst.extract(2.2);
+    nh.key() = 4.4;
+    dst.insert(std::move(nh));
+
+    // 在栈上的缓冲区中分配：
+    std::array<std::byte, 4096> buf;
+    std::pmr::monotonic_buffer_resource pool{buf.data(), buf.size()};
+    pmr::flat_map<double, std::pmr::string> pm{&pool};
+    std::vector<std::pair<double, std::pmr::string>> sorted{{0.5, "half"}, {5.5, "big"}};
+    pm.insert_sorted(sorted.begin(), sorted.end());
+    for (const auto& [key, value] : dst) {
+        pm.emplace(key, value);
+    }
+    print(dst, pm);
+
+    // 和自己归并不会改变任何元素，const的map也可以使用at()：
+    dst.merge(dst);
+    const auto& cdst = dst;
+    std::cout << "after dst.merge(dst): " << cdst.at(1.1) << ' ' << cdst.at(4.4) << '\n';
+    try {
+        cdst.at(9.9);
+    }
+    catch (const std::out_of_range& e) {
+        std::cout << "EXCEPTION: " << e.what() << '\n';
+    }
+
+    // 随机访问迭代器：
+    auto it = dst.begin();
+    it = dst.end();                             // 默认的拷贝赋值运算符
+    flat_map<double, std::string>::const_iterator cit = it;
+    bool ok = 1 + dst.begin() == dst.begin() + 1 && it > dst.begin() && cit >= dst.cbegin()
+              && dst.cbegin() <= cit && it - dst.begin() == static_cast<long>(dst.size());
+    std::cout << "iterator: " << (ok ? "OK" : "ERROR") << '\n';
+
+    // 比较函数抛出异常时，归并中的容器被清空而不是留下移走的元素：
+    struct ThrowingLess {
+        int* budget;
+        bool operator() (int a, int b) const {
+            if (--*budget < 0) {
+                throw std::runtime_error{"comparison failed"};
+            }
+            return a < b;
+        }
+    };
+    int budget = 1000;
+    flat_map<int, std::string, ThrowingLess> a{ThrowingLess{&budget}}, b{ThrowingLess{&budget}};
+    for (int i = 0; i < 10; ++i) {
+        a.emplace(i * 2, std::string(20, 'a' + i));
+        b.emplace(i * 2 + 1, std::string(20, 'a' + i));
+    }
+    budget = 5;
+    try {
+        a.merge(b);
+    }
+    catch (const std::runtime_error& e) {
+        std::cout << "EXCEPTION: " << e.what() << ", sizes afterwards: " << a.size() << ' '
+                  << b.size() << '\n';
+    }
+}
+
+template<typename Map>
+void benchLookup(const std::string& name, const Map& m,
+                 const std::vector<long>& probes)
+{
+    Timer t;
+    long found = 0;
+    for (long k : probes) {
+        found += m.find(k) != m.end();
+    }
+    t.printDiff("  " + name + " find():    ");
+    long sum = 0;
+    for (const auto& [key, value] : m) {
+        sum += value;
+    }
+    t.printDiff("  " + name + " iterate(): ");
+    std::cout << "    found: " << found << ", sum: " << sum << '\n';
+}
+
+int main(int argc, char* argv[])
+{
+    demo();
+
+    long maxElems = argc > 1 ? std::atol(argv[1]) : 10'000'000;
+    std::mt19937 eng{42};
+
+    // 查找和遍历：
+    for (long num = 1000; num <= maxElems; num *= 10) {
+        std::cout << num << " elements:\n";
+        std::vector<std::pair<long, long>> sorted;
+        sorted.reserve(num);
+        for (long i = 0; i < num; ++i) {
+            sorted.emplace_back(i * 2, i);
+        }
+        std::map<long, long> m(sorted.begin(), sorted.end());
+        flat_map<long, long> fm;
+        fm.insert_sorted(sorted.begin(), sorted.end());
+
+        std::uniform_int_distribution<long> dist{0, num * 2};
+        std::vector<long> probes(1'000'000);
+        for (auto& p : probes) {
+            p = dist(eng);
+        }
+        benchLookup("std::map", m, probes);
+        benchLookup("flat_map", fm, probes);
+    }
+
+    // 随机顺序逐个插入：flat_map每次要移动O(n)个元素，
+    // 所以元素较多时std::map更快：
+    std::cout << "random single inserts:\n";
+    for (long num = 1000; num <= std::min(maxElems, 100'000L); num *= 10) {
+        std::vector<long> keys(num);
+        for (auto& k : keys) {
+            k = eng();
+        }
+        Timer t;
+        std::map<long, long> m;
+        for (long k : keys) {
+            m.emplace(k, k);
+        }
+        t.printDiff("  " + std::to_string(num) + " std::map: ");
+        flat_map<long, long> fm;
+        for (long k : keys) {
+            fm.emplace(k, k);
+        }
+        t.printDiff("  " + std::to_string(num) + " flat_map: ");
+    }
+}
@@ -0,0 +1,445 @@
+#ifndef FLATMAP_HPP
+#define FLATMAP_HPP
+
+#include <vector>
+#include <memory_resource>
+#include <optional>
+#include <utility>      // for std::pair, std::move(), std::move_if_noexcept()
+#include <functional>   // for std::less<>
+#include <algorithm>    // for lower_bound(), upper_bound()
+#include <iterator>     // for std::iterator_traits, std::distance()
+#include <type_traits>  // for std::is_base_of_v, std::is_nothrow_move_constructible_v
+#include <stdexcept>    // for std::out_of_range
+
+/********************************************
+* flat_map/flat_multimap：用两个有序的连续数组存储键和值
+* - 查找只需要在连续的键数组中二分查找
+* - 提供和节点句柄形状相同的extract()/insert()/merge()接口
+* - insert_sorted()批量插入有序的元素
+* - pmr::flat_map使用多态分配器
+* 异常安全：insert_sorted()和merge()先归并到新的数组中，最后才交换
+* - 如果键和值的移动构造可能抛出异常，已有的元素被复制，所以出现异常时容器不变
+* - 否则已有的元素被移动，归并时比较函数或者分配内存抛出异常的话，
+*   被移走的元素无法恢复，相关的容器会被清空（基本保证）
+********************************************/
+
+template<typename Key, typename T, typename Compare,
+         typename KeyContainer, typename MappedContainer, bool Multi>
+class FlatMapBase
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+
+    // 类似于节点句柄：存放一个从容器中取出的元素
+    class node_type {
+    private:
+        std::optional<std::pair<Key, T>> elem;
+        friend class FlatMapBase;
+    public:
+        node_type() = default;
+        bool empty() const {
+            return !elem.has_value();
+        }
+        explicit operator bool() const {
+            return elem.has_value();
+        }
+        Key& key() const {
+            return const_cast<Key&>(elem->first);
+        }
+        T& mapped() const {
+            return const_cast<T&>(elem->second);
+        }
+    };
+
+    struct insert_return_type {
+        std::size_t position;   // 元素的下标
+        bool inserted;
+        node_type node;         // 插入失败时节点在这里
+    };
+
+    // 迭代器返回临时的pair<const Key&, T&>，所以也可以用于结构化绑定：
+    template<bool Const>
+    class Iter {
+    private:
+        using KP = const Key*;
+        using VP = std::conditional_t<Const, const T*, T*>;
+        KP kp = nullptr;
+        VP vp = nullptr;
+        friend class FlatMapBase;
+        Iter(KP k, VP v) : kp{k}, vp{v} {
+        }
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::pair<const Key&, std::conditional_t<Const, const T&, T&>>;
+        using value_type = std::pair<Key, T>;
+        struct pointer {
+            reference ref;
+            const reference* operator-> () const {
+                return &ref;
+            }
+        };
+
+        Iter() = default;
+        Iter(const Iter&) = default;
+        Iter& operator= (const Iter&) = default;
+        // iterator => const_iterator（只有const_iterator才有这个构造函数）：
+        template<bool C = Const, typename = std::enable_if_t<C>>
+        Iter(const Iter<false>& i) : kp{i.kp}, vp{i.vp} {
+        }
+        reference operator* () const {
+            return {*kp, *vp};
+        }
+        pointer operator-> () const {
+            return {**this};
+        }
+        reference operator[] (difference_type n) const {
+            return {kp[n], vp[n]};
+        }
+        Iter& operator++ () { ++kp; ++vp; return *this; }
+        Iter& operator-- () { --kp; --vp; return *this; }
+        Iter operator++ (int) { auto tmp = *this; ++*this; return tmp; }
+        Iter operator-- (int) { auto tmp = *this; --*this; return tmp; }
+        Iter& operator+= (difference_type n) { kp += n; vp += n; return *this; }
+        Iter& operator-= (difference_type n) { kp -= n; vp -= n; return *this; }
+        friend Iter operator+ (Iter i, difference_type n) { return i += n; }
+        friend Iter operator+ (difference_type n, Iter i) { return i += n; }
+        friend Iter operator- (Iter i, difference_type n) { return i -= n; }
+        friend difference_type operator- (const Iter& a, const Iter& b) {
+            return a.kp - b.kp;
+        }
+        friend bool operator== (const Iter& a, const Iter& b) { return a.kp == b.kp; }
+        friend bool operator!= (const Iter& a, const Iter& b) { return a.kp != b.kp; }
+        friend bool operator< (const Iter& a, const Iter& b) { return a.kp < b.kp; }
+        friend bool operator> (const Iter& a, const Iter& b) { return a.kp > b.kp; }
+        friend bool operator<= (const Iter& a, const Iter& b) { return a.kp <= b.kp; }
+        friend bool operator>= (const Iter& a, const Iter& b) { return a.kp >= b.kp; }
+        template<bool> friend class Iter;
+    };
+    using iterator = Iter<false>;
+    using const_iterator = Iter<true>;
+
+private:
+    KeyContainer keys;
+    MappedContainer values;
+    Compare comp;
+
+    std::size_t lowerIdx(const Key& k) const {
+        return std::lower_bound(keys.begin(), keys.end(), k, comp) - keys.begin();
+    }
+    std::size_t upperIdx(const Key& k) const {
+        return std::upper_bound(keys.begin(), keys.end(), k, comp) - keys.begin();
+    }
+    bool equalKeys(const Key& a, const Key& b) const {
+        return !comp(a, b) && !comp(b, a);
+    }
+    iterator iterAt(std::size_t idx) {
+        return {keys.data() + idx, values.data() + idx};
+    }
+    const_iterator iterAt(std::size_t idx) const {
+        return {keys.data() + idx, values.data() + idx};
+    }
+    std::size_t idx(const_iterator pos) const {
+        return pos.kp - keys.data();
+    }
+    // 归并时已有的元素是否被移动（否则被复制，见开头的说明）：
+    static constexpr bool moveExisting = std::is_nothrow_move_constructible_v<Key>
+                                         && std::is_nothrow_move_constructible_v<T>;
+    // 在下标idx处插入（调用者保证顺序正确）：
+    template<typename K, typename V>
+    iterator insertAt(std::size_t idx, K&& k, V&& v) {
+        keys.emplace(keys.begin() + idx, std::forward<K>(k));
+        values.emplace(values.begin() + idx, std::forward<V>(v));
+        return iterAt(idx);
+    }
+    // 找到插入位置，对flat_map来说键已经存在时返回false：
+    std::pair<std::size_t, bool> findInsertPos(const Key& k) const {
+        if constexpr (Multi) {
+            return {upperIdx(k), true};
+        }
+        else {
+            auto i = lowerIdx(k);
+            return {i, i == keys.size() || comp(k, keys[i])};
+        }
+    }
+
+public:
+    FlatMapBase() = default;
+    explicit FlatMapBase(const Compare& c) : comp{c} {
+    }
+    // 用分配器（例如pmr::memory_resource*）初始化两个数组：
+    template<typename Alloc,
+             typename = std::enable_if_t<
+                 std::is_constructible_v<typename KeyContainer::allocator_type, const Alloc&>>>
+    explicit FlatMapBase(const Alloc& a, const Compare& c = Compare{})
+     : keys(typename KeyContainer::allocator_type(a)),
+       values(typename MappedContainer::allocator_type(a)), comp{c} {
+    }
+    FlatMapBase(std::initializer_list<std::pair<Key, T>> il) {
+        for (const auto& [k, v] : il) {
+            emplace(k, v);
+        }
+    }
+
+    iterator begin() { return iterAt(0); }
+    iterator end() { return iterAt(keys.size()); }
+    const_iterator begin() const { return iterAt(0); }
+    const_iterator end() const { return iterAt(keys.size()); }
+    const_iterator cbegin() const { return iterAt(0); }
+    const_iterator cend() const { return iterAt(keys.size()); }
+
+    bool empty() const { return keys.empty(); }
+    std::size_t size() const { return keys.size(); }
+    void reserve(std::size_t n) { keys.reserve(n); values.reserve(n); }
+    void clear() { keys.clear(); values.clear(); }
+    const KeyContainer& keyData() const { return keys; }
+    const MappedContainer& valueData() const { return values; }
+    key_compare key_comp() const { return comp; }
+
+    // 查找：
+    iterator lower_bound(const Key& k) { return iterAt(lowerIdx(k)); }
+    iterator upper_bound(const Key& k) { return iterAt(upperIdx(k)); }
+    const_iterator lower_bound(const Key& k) const { return iterAt(lowerIdx(k)); }
+    const_iterator upper_bound(const Key& k) const { return iterAt(upperIdx(k)); }
+    iterator find(const Key& k) {
+        auto i = lowerIdx(k);
+        return i != keys.size() && !comp(k, keys[i]) ? iterAt(i) : end();
+    }
+    const_iterator find(const Key& k) const {
+        auto i = lowerIdx(k);
+        return i != keys.size() && !comp(k, keys[i]) ? iterAt(i) : end();
+    }
+    bool contains(const Key& k) const {
+        return find(k) != end();
+    }
+    std::size_t count(const Key& k) const {
+        return upperIdx(k) - lowerIdx(k);
+    }
+
+    // 只有flat_map才有的成员：
+    template<bool M = Multi, typename = std::enable_if_t<!M>>
+    T& operator[] (const Key& k) {
+        auto [i, isNew] = findInsertPos(k);
+        if (isNew) {
+            insertAt(i, k, T{});
+        }
+        return values[i];
+    }
+    template<bool M = Multi, typename = std::enable_if_t<!M>>
+    T& at(const Key& k) {
+        auto pos = find(k);
+        if (pos == end()) {
+            throw std::out_of_range{"flat_map::at()"};
+        }
+        return (*pos).second;
+    }
+    template<bool M = Multi, typename = std::enable_if_t<!M>>
+    const T& at(const Key& k) const {
+        auto pos = find(k);
+        if (pos == end()) {
+            throw std::out_of_range{"flat_map::at()"};
+        }
+        return (*pos).second;
+    }
+
+    // 插入单个元素（需要移动后面的所有元素）：
+    template<typename K, typename V>
+    auto emplace(K&& k, V&& v) {
+        auto [i, ok] = findInsertPos(k);
+        if constexpr (Multi) {
+            return insertAt(i, std::forward<K>(k), std::forward<V>(v));
+        }
+        else {
+            return std::pair{ok ? insertAt(i, std::forward<K>(k), std::forward<V>(v)) : iterAt(i),
+                             ok};
+        }
+    }
+    auto insert(std::pair<Key, T> elem) {
+        return emplace(std::move(elem.first), std::move(elem.second));
+    }
+
+    // 批量插入已经按键排序的元素：
+    // - 如果所有新的键都在末尾就直接追加
+    // - 否则把新旧两个有序序列归并一次
+    template<typename InputIt>
+    void insert_sorted(InputIt first, InputIt last) {
+        if (first == last) {
+            return;
+        }
+        // 直接从输入范围中读取（不经过临时的vector，所以也不会绕过容器的分配器），
+        // 元素是右值时（例如move_iterator）移动，否则复制：
+        constexpr bool forward = std::is_base_of_v<std::forward_iterator_tag,
+                           typename std::iterator_traits<InputIt>::iterator_category>;
+        std::size_t hint = 0;
+        if constexpr (forward) {
+            hint = static_cast<std::size_t>(std::distance(first, last));
+        }
+        if (keys.empty() || comp(keys.back(), (*first).first)
+                         || (Multi && !comp((*first).first, keys.back()))) {
+            reserve(keys.size() + hint);
+            for (; first != last; ++first) {
+                auto&& elem = *first;
+                if (Multi || keys.empty() || comp(keys.back(), elem.first)) {
+                    keys.push_back(std::forward<decltype(elem)>(elem).first);
+                    values.push_back(std::forward<decltype(elem)>(elem).second);
+                }
+            }
+            return;
+        }
+        KeyContainer newKeys(keys.get_allocator());
+        MappedContainer newValues(values.get_allocator());
+        newKeys.reserve(keys.size() + hint);
+        newValues.reserve(keys.size() + hint);
+        auto push = [&] (auto&& k, auto&& v) {
+                        if (Multi || newKeys.empty() || comp(newKeys.back(), k)) {
+                            newKeys.push_back(std::forward<decltype(k)>(k));
+                            newValues.push_back(std::forward<decltype(v)>(v));
+                        }
+                    };
+        std::size_t i = 0;
+        try {
+            for (; first != last; ++first) {
+                auto&& elem = *first;
+                // 已有的元素排在相等的新元素前面：
+                while (i < keys.size() && !comp(elem.first, keys[i])) {
+                    push(std::move_if_noexcept(keys[i]), std::move_if_noexcept(values[i]));
+                    ++i;
+                }
+                push(std::forward<decltype(elem)>(elem).first,
+                     std::forward<decltype(elem)>(elem).second);
+            }
+            for (; i < keys.size(); ++i) {
+                push(std::move_if_noexcept(keys[i]), std::move_if_noexcept(values[i]));
+            }
+        }
+        catch (...) {
+            if (moveExisting && i > 0) {
+                clear();    // 有些元素已经被移走
+            }
+            throw;
+        }
+        keys.swap(newKeys);
+        values.swap(newValues);
+    }
+
+    iterator erase(const_iterator pos) {
+        auto i = idx(pos);
+        keys.erase(keys.begin() + i);
+        values.erase(values.begin() + i);
+        return iterAt(i);
+    }
+    std::size_t erase(const Key& k) {
+        auto lo = lowerIdx(k), hi = upperIdx(k);
+        keys.erase(keys.begin() + lo, keys.begin() + hi);
+        values.erase(values.begin() + lo, values.begin() + hi);
+        return hi - lo;
+    }
+
+    // 和节点句柄形状相同的接口：
+    node_type extract(const_iterator pos) {
+        node_type nh;
+        auto i = idx(pos);
+        nh.elem.emplace(std::move(keys[i]), std::move(values[i]));
+        erase(pos);
+        return nh;
+    }
+    node_type extract(const Key& k) {
+        auto pos = find(k);
+        return pos == end() ? node_type{} : extract(pos);
+    }
+    auto insert(node_type&& nh) {
+        if constexpr (Multi) {
+            if (nh.empty()) {
+                return end();
+            }
+            auto pos = emplace(std::move(nh.key()), std::move(nh.mapped()));
+            nh.elem.reset();
+            return pos;
+        }
+        else {
+            if (nh.empty()) {
+                return insert_return_type{size(), false, node_type{}};
+            }
+            auto [i, ok] = findInsertPos(nh.key());
+            if (!ok) {
+                return insert_return_type{i, false, std::move(nh)};
+            }
+            insertAt(i, std::move(nh.key()), std::move(nh.mapped()));
+            nh.elem.reset();
+            return insert_return_type{i, true, node_type{}};
+        }
+    }
+
+    // 把src中所有的元素归并进来（O(n+m)）；
+    // 对flat_map来说，键已经存在的元素留在src中：
+    template<typename KC2, typename MC2, bool Multi2>
+    void merge(FlatMapBase<Key, T, Compare, KC2, MC2, Multi2>& src) {
+        if (static_cast<const void*>(&src) == this) {
+            return;     // 和std::map::merge()一样，和自己归并什么也不做
+        }
+        KeyContainer newKeys(keys.get_allocator());
+        MappedContainer newValues(values.get_allocator());
+        newKeys.reserve(keys.size() + src.keys.size());
+        newValues.reserve(keys.size() + src.keys.size());
+        KC2 restKeys(src.keys.get_allocator());
+        MC2 restValues(src.values.get_allocator());
+        std::size_t i = 0, j = 0;
+        try {
+            while (i < keys.size() || j < src.keys.size()) {
+                if (j == src.keys.size()
+                    || (i < keys.size() && !comp(src.keys[j], keys[i]))) {
+                    newKeys.push_back(std::move_if_noexcept(keys[i]));
+                    newValues.push_back(std::move_if_noexcept(values[i]));
+                    ++i;
+                }
+                else if (!Multi && !newKeys.empty() && equalKeys(newKeys.back(), src.keys[j])) {
+                    restKeys.push_back(std::move_if_noexcept(src.keys[j]));
+                    restValues.push_back(std::move_if_noexcept(src.values[j]));
+                    ++j;
+                }
+                else {
+                    newKeys.push_back(std::move_if_noexcept(src.keys[j]));
+                    newValues.push_back(std::move_if_noexcept(src.values[j]));
+                    ++j;
+                }
+            }
+        }
+        catch (...) {
+            if (moveExisting && (i > 0 || j > 0)) {
+                clear();    // 有些元素已经被移走
+                src.clear();
+            }
+            throw;
+        }
+        keys.swap(newKeys);
+        values.swap(newValues);
+        src.keys.swap(restKeys);
+        src.values.swap(restValues);
+    }
+    template<typename, typename, typename, typename, typename, bool>
+    friend class FlatMapBase;
+};
+
+template<typename Key, typename T, typename Compare = std::less<Key>,
+         typename KeyContainer = std::vector<Key>,
+         typename MappedContainer = std::vector<T>>
+using flat_map = FlatMapBase<Key, T, Compare, KeyContainer, MappedContainer, false>;
+
+template<typename Key, typename T, typename Compare = std::less<Key>,
+         typename KeyContainer = std::vector<Key>,
+         typename MappedContainer = std::vector<T>>
+using flat_multimap = FlatMapBase<Key, T, Compare, KeyContainer, MappedContainer, true>;
+
+namespace pmr {
+    template<typename Key, typename T, typename Compare = std::less<Key>>
+    using flat_map = ::flat_map<Key, T, Compare,
+                                std::pmr::vector<Key>, std::pmr::vector<T>>;
+    template<typename Key, typename T, typename Compare = std::less<Key>>
+    using flat_multimap = ::flat_multimap<Key, T, Compare,
+                                          std::pmr::vector<Key>, std::pmr::vector<T>>;
+}
+
+#endif  // FLATMAP_HPP
@@ -0,0 +1,134 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>      // for std::atoi()
+#include <stdexcept>
+#include "flattree.hpp"
+#include "timer.hpp"
+
+// 和incomplete.hpp中的Node相同，只是添加了用于比较的遍历函数：
+class Node
+{
+private:
+    std::string value;
+    std::vector<Node> children;
+public:
+    Node(std::string s) : value{std::move(s)}, children{} {
+    }
+    void add(Node n) {
+        children.push_back(std::move(n));
+    }
+    Node& operator[](std::size_t idx) {
+        return children.at(idx);
+    }
+    void print(int indent = 0) const {
+        std::cout << std::string(indent, ' ') << value << '\n';
+        for (const auto& n : children) {
+            n.print(indent + 2);
+        }
+    }
+    std::size_t sumLengths() const {
+        std::size_t sum = value.size();
+        for (const auto& n : children) {
+            sum += n.sumLengths();
+        }
+        return sum;
+    }
+};
+
+// 每个节点有fanout个子节点，共depth层：
+Node buildNode(int depth, int fanout, int& count)
+{
+    Node n{"elem" + std::to_string(count++ % 1000)};
+    if (depth > 1) {
+        for (int i = 0; i < fanout; ++i) {
+            n.add(buildNode(depth - 1, fanout, count));
+        }
+    }
+    return n;
+}
+
+void buildFlat(FlatTree::Builder& b, int depth, int fanout, int& count)
+{
+    std::string value = "elem" + std::to_string(count++ % 1000);
+    if (depth > 1) {
+        b.open(value);
+        for (int i = 0; i < fanout; ++i) {
+            buildFlat(b, depth - 1, fanout, count);
+        }
+        b.close();
+    }
+    else {
+        b.leaf(value);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // 和incomplete.cpp相同的树：
+    FlatTree tree;
+    auto root = tree.addRoot("top");
+    tree.add(root, "elem1");
+    tree.add(root, "elem2");
+    tree.add(tree.child(root, 0), "elem1.1");
+    tree.print();
+
+    // 空字符串和比块（64KiB）还大的字符串：
+    StringPool pool;
+    auto empty = pool.intern("");
+    std::string big(100'000, 'x');
+    auto bigId = pool.intern(big);
+    auto small = pool.intern("small");
+    std::cout << "StringPool: " << (pool[empty].empty() && pool[bigId] == big
+                                    && pool[small] == "small" && pool.intern(big) == bigId
+                                    ? "OK" : "ERROR") << '\n';
+
+    // Builder只允许一个根节点，第二个顶层节点不会清空已经构建的树：
+    {
+        FlatTree ft;
+        FlatTree::Builder b{ft};
+        b.open("root").leaf("child").close();
+        try {
+            b.leaf("second root");
+        }
+        catch (const std::logic_error& e) {
+            std::cout << "EXCEPTION: " << e.what() << ", nodes kept: " << ft.size() << '\n';
+        }
+    }
+
+    // 每个节点10个子节点，默认7层（大约一百万个节点）：
+    int depth = argc > 1 ? std::atoi(argv[1]) : 7;
+    int fanout = 10;
+    Timer t;
+    {
+        int count = 0;
+        Node n = buildNode(depth, fanout, count);
+        t.printDiff("Node build:        ");
+        std::cout << "  " << count << " nodes, lengths: " << n.sumLengths() << '\n';
+        t.printDiff("Node traverse:     ");
+    }
+    t.printDiff("Node destroy:      ");
+    {
+        FlatTree ft;
+        int count = 0;
+        FlatTree::Builder b{ft};
+        buildFlat(b, depth, fanout, count);
+        t.printDiff("FlatTree build:    ");
+        std::size_t sum = 0;
+        for (auto pos = ft.begin(); pos != ft.end(); ++pos) {
+            sum += ft.value(*pos).size();
+        }
+        std::cout << "  " << ft.size() << " nodes, lengths: " << sum << '\n';
+        t.printDiff("FlatTree DFS:      ");
+        sum = 0;
+        ft.forEachBfs([&] (FlatTree::NodeId id, int) {
+                          sum += ft.value(id).size();
+                      });
+        t.printDiff("FlatTree BFS:      ");
+        std::string buf;
+        ft.print(buf);
+        t.printDiff("FlatTree print:    ");
+        std::cout << "  " << buf.size() << " bytes printed\n";
+    }
+    t.printDiff("FlatTree destroy:  ");
+}
@@ -0,0 +1,245 @@
+#ifndef FLATTREE_HPP
+#define FLATTREE_HPP
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <memory>       // for std::unique_ptr
+#include <cstring>      // for memcpy()
+#include <cstdint>
+#include <stdexcept>    // for std::logic_error
+#include <iostream>
+
+/********************************************
+* FlatTree：所有节点存放在一个连续的数组中
+* - 节点之间用下标（第一个子节点/下一个兄弟节点）连接
+* - 节点的值被驻留在StringPool中，相同的值只存储一次
+* - 非递归的深度优先（先序）和广度优先遍历
+* - 打印时只写入一个缓冲区
+********************************************/
+
+// 字符串驻留池：字符串存放在固定大小的块中，所以string_view一直有效
+class StringPool
+{
+private:
+    static constexpr std::size_t blockSize = 64 * 1024;
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::size_t used = blockSize;           // 当前块中已经使用的字节数
+    std::vector<std::string_view> values;   // id => 值
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+
+    std::string_view store(std::string_view s) {
+        if (s.size() > blockSize) {
+            // 比块还大的字符串使用单独的块（插入到当前块前面，当前块不变）：
+            auto big = std::make_unique<char[]>(s.size());
+            std::memcpy(big.get(), s.data(), s.size());
+            std::string_view sv{big.get(), s.size()};
+            blocks.insert(blocks.empty() ? blocks.end() : blocks.end() - 1, std::move(big));
+            return sv;
+        }
+        if (blocks.empty() || s.size() > blockSize - used) {
+            blocks.push_back(std::make_unique<char[]>(blockSize));
+            used = 0;
+        }
+        char* p = blocks.back().get() + used;
+        if (!s.empty()) {
+            std::memcpy(p, s.data(), s.size());
+        }
+        used += s.size();
+        return {p, s.size()};
+    }
+public:
+    std::uint32_t intern(std::string_view s) {
+        if (auto pos = ids.find(s); pos != ids.end()) {
+            return pos->second;
+        }
+        auto sv = store(s);
+        auto id = static_cast<std::uint32_t>(values.size());
+        values.push_back(sv);
+        ids.emplace(sv, id);
+        return id;
+    }
+    std::string_view operator[] (std::uint32_t id) const {
+        return values[id];
+    }
+    std::size_t size() const {
+        return values.size();
+    }
+};
+
+class FlatTree
+{
+public:
+    using NodeId = std::uint32_t;
+    static constexpr NodeId none = static_cast<NodeId>(-1);
+private:
+    struct NodeRec {
+        std::uint32_t value;
+        NodeId parent;
+        NodeId firstChild = none;
+        NodeId lastChild = none;    // 用于在O(1)时间内追加子节点
+        NodeId nextSibling = none;
+    };
+    std::vector<NodeRec> nodes;
+    StringPool pool;
+public:
+    void reserve(std::size_t n) {
+        nodes.reserve(n);
+    }
+    std::size_t size() const {
+        return nodes.size();
+    }
+
+    // 创建根节点（总是下标0）：
+    NodeId addRoot(std::string_view value) {
+        nodes.clear();
+        nodes.push_back(NodeRec{pool.intern(value), none});
+        return 0;
+    }
+    // 添加子节点：
+    NodeId add(NodeId parent, std::string_view value) {
+        auto id = static_cast<NodeId>(nodes.size());
+        nodes.push_back(NodeRec{pool.intern(value), parent});
+        auto& p = nodes[parent];
+        if (p.lastChild == none) {
+            p.firstChild = id;
+        }
+        else {
+            nodes[p.lastChild].nextSibling = id;
+        }
+        p.lastChild = id;
+        return id;
+    }
+
+    std::string_view value(NodeId id) const {
+        return pool[nodes[id].value];
+    }
+    NodeId parent(NodeId id) const { return nodes[id].parent; }
+    NodeId firstChild(NodeId id) const { return nodes[id].firstChild; }
+    NodeId nextSibling(NodeId id) const { return nodes[id].nextSibling; }
+    // 访问第idx个子节点（和Node::operator[]对应）：
+    NodeId child(NodeId id, std::size_t idx) const {
+        NodeId c = nodes[id].firstChild;
+        for (; idx > 0 && c != none; --idx) {
+            c = nodes[c].nextSibling;
+        }
+        return c;
+    }
+
+    // 不需要栈的先序遍历（利用parent链接回溯）：
+    class DfsIterator {
+    private:
+        const FlatTree* tree;
+        NodeId cur;
+        int dep = 0;
+    public:
+        DfsIterator(const FlatTree* t, NodeId n) : tree{t}, cur{n} {
+        }
+        NodeId operator* () const {
+            return cur;
+        }
+        int depth() const {
+            return dep;
+        }
+        DfsIterator& operator++ () {
+            const auto& nodes = tree->nodes;
+            if (nodes[cur].firstChild != none) {
+                cur = nodes[cur].firstChild;
+                ++dep;
+                return *this;
+            }
+            while (cur != none && nodes[cur].nextSibling == none) {
+                cur = nodes[cur].parent;
+                --dep;
+            }
+            if (cur != none) {
+                cur = nodes[cur].nextSibling;
+            }
+            return *this;
+        }
+        bool operator!= (const DfsIterator& i) const {
+            return cur != i.cur;
+        }
+    };
+    DfsIterator begin() const {
+        return {this, nodes.empty() ? none : 0};
+    }
+    DfsIterator end() const {
+        return {this, none};
+    }
+
+    // 广度优先遍历，对每个节点调用op(id, depth)：
+    template<typename Op>
+    void forEachBfs(Op op) const {
+        if (nodes.empty()) {
+            return;
+        }
+        std::vector<std::pair<NodeId, int>> queue;
+        queue.reserve(nodes.size());
+        queue.emplace_back(0, 0);
+        for (std::size_t i = 0; i < queue.size(); ++i) {
+            auto [id, depth] = queue[i];
+            op(id, depth);
+            for (NodeId c = nodes[id].firstChild; c != none; c = nodes[c].nextSibling) {
+                queue.emplace_back(c, depth + 1);
+            }
+        }
+    }
+
+    // 把整个树写入缓冲区（和Node::print()的格式相同）：
+    void print(std::string& buf) const {
+        for (auto pos = begin(); pos != end(); ++pos) {
+            buf.append(2 * pos.depth(), ' ');
+            buf.append(value(*pos));
+            buf.push_back('\n');
+        }
+    }
+    void print() const {
+        std::string buf;
+        print(buf);
+        std::cout.write(buf.data(), buf.size());    // 只写一次
+    }
+
+    // 批量构建：按先序依次打开/关闭节点，
+    // 这样节点在数组中的顺序就是深度优先遍历的顺序
+    class Builder {
+    private:
+        FlatTree& tree;
+        std::vector<NodeId> stack;
+        bool hasRoot = false;
+    public:
+        explicit Builder(FlatTree& t, std::size_t expectedSize = 0) : tree{t} {
+            tree.nodes.clear();
+            tree.reserve(expectedSize);
+        }
+        // 添加一个节点并把它作为之后添加的节点的父节点：
+        Builder& open(std::string_view value) {
+            stack.push_back(leafId(value));
+            return *this;
+        }
+        // 添加一个没有子节点的节点：
+        Builder& leaf(std::string_view value) {
+            leafId(value);
+            return *this;
+        }
+        Builder& close() {
+            stack.pop_back();
+            return *this;
+        }
+    private:
+        NodeId leafId(std::string_view value) {
+            if (!stack.empty()) {
+                return tree.add(stack.back(), value);
+            }
+            // 第二个顶层节点会导致addRoot()清空已经构建的树：
+            if (hasRoot) {
+                throw std::logic_error{"FlatTree::Builder: more than one root"};
+            }
+            hasRoot = true;
+            return tree.addRoot(value);
+        }
+    };
+};
+
+#endif  // FLATTREE_HPP
@@ -0,0 +1,69 @@
+#include "../lang/tracknew.hpp"
+#include <iostream>
+#include <string>
+#include <map>
+#include <cstdlib>      // for std::atoi()
+#include "nodesplice.hpp"
+#include "timer.hpp"
+
+using Shard = std::map<int, std::string>;
+
+Shard makeShard(int num)
+{
+    Shard m;
+    for (int i = 0; i < num; ++i) {
+        m.emplace(i, "value number " + std::to_string(i));
+    }
+    return m;
+}
+
+int main(int argc, char* argv[])
+{
+    int num = argc > 1 ? std::atoi(argv[1]) : 500'000;
+    int lo = num / 4;
+    int hi = lo + num / 2;
+    auto rekey = [num] (int k) { return k + num; };   // 新的键在目标中是连续的
+
+    // 逐个extract()/insert()：
+    {
+        Shard src = makeShard(num), dst = makeShard(num);
+        TrackNew::reset();
+        Timer t;
+        auto pos = src.lower_bound(lo);
+        auto end = src.lower_bound(hi);
+        while (pos != end) {
+            auto nh = src.extract(pos++);
+            nh.key() = rekey(nh.key());
+            dst.insert(std::move(nh));
+        }
+        t.printDiff("element-wise extract/insert: ");
+        TrackNew::status();
+    }
+
+    // 批量地extract()、原地修改键、带提示地插入：
+    {
+        Shard src = makeShard(num), dst = makeShard(num);
+        NodeList<Shard> buf;
+        buf.reserve(hi - lo);   // 只分配一次，之后可以重用
+        TrackNew::reset();
+        Timer t;
+        auto moved = spliceRange(src, dst, lo, hi, rekey, buf);
+        t.printDiff("bulk spliceRange():          ");
+        TrackNew::status();
+        std::cout << "  moved " << moved << " nodes, dst has "
+                  << dst.size() << " elements\n";
+    }
+
+    // merge()（不能修改键）：
+    {
+        Shard src = makeShard(num), dst;
+        for (int i = 0; i < num; ++i) {
+            dst.emplace(i + num, "other");
+        }
+        TrackNew::reset();
+        Timer t;
+        dst.merge(src);
+        t.printDiff("merge() (no re-keying):      ");
+        TrackNew::status();
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef NODESPLICE_HPP
+#define NODESPLICE_HPP
+
+#include <vector>
+#include <algorithm>    // for sort(), is_sorted(), remove_if()
+#include <iterator>     // for std::next()
+#include <utility>      // for std::move()
+
+/********************************************
+* NodeList：批量地在map/multimap之间移动节点
+* - extract()把一个键区间的节点取出到列表中
+* - rekey()原地修改键（不重新分配节点）
+* - insertInto()按顺序带提示地插回，每个节点平摊O(1)
+* 列表可以重用：clear()之后保留已分配的容量
+********************************************/
+
+template<typename Map>
+class NodeList
+{
+public:
+    using node_type = typename Map::node_type;
+    using key_type = typename Map::key_type;
+private:
+    std::vector<node_type> nodes;
+    typename Map::key_compare comp;
+public:
+    explicit NodeList(typename Map::key_compare c = {}) : comp{c} {
+    }
+
+    void reserve(std::size_t n) {
+        nodes.reserve(n);
+    }
+    std::size_t size() const {
+        return nodes.size();
+    }
+    bool empty() const {
+        return nodes.empty();
+    }
+    // 销毁剩余的节点，但保留列表的容量：
+    void clear() {
+        nodes.clear();
+    }
+    auto begin() {
+        return nodes.begin();
+    }
+    auto end() {
+        return nodes.end();
+    }
+
+    // 把[lo, hi)中所有的节点追加到列表中（保持有序）：
+    std::size_t extract(Map& m, const key_type& lo, const key_type& hi) {
+        std::size_t num = 0;
+        auto pos = m.lower_bound(lo);
+        auto end = m.lower_bound(hi);
+        while (pos != end) {
+            nodes.push_back(m.extract(pos++));
+            ++num;
+        }
+        return num;
+    }
+
+    // 原地修改所有的键，如果新键的顺序被打乱就重新排序：
+    template<typename F>
+    void rekey(F f) {
+        for (auto& nh : nodes) {
+            nh.key() = f(nh.key());
+        }
+        auto less = [this] (const node_type& a, const node_type& b) {
+                        return comp(a.key(), b.key());
+                    };
+        if (!std::is_sorted(nodes.begin(), nodes.end(), less)) {
+            std::stable_sort(nodes.begin(), nodes.end(), less);
+        }
+    }
+
+    // 按顺序带提示地把所有节点插入m，返回插入的数量
+    // （对map来说，键已经存在的节点会留在列表中）：
+    std::size_t insertInto(Map& m) {
+        if (nodes.empty()) {
+            return 0;
+        }
+        std::size_t num = 0;
+        auto hint = m.lower_bound(nodes.front().key());
+        for (auto& nh : nodes) {
+            auto pos = m.insert(hint, std::move(nh));
+            if (nh.empty()) {
+                ++num;
+            }
+            hint = std::next(pos);  // 下一个（更大的）键应该插入到这里
+        }
+        nodes.erase(std::remove_if(nodes.begin(), nodes.end(),
+                                   [] (const node_type& nh) {
+                                       return nh.empty();
+                                   }),
+                    nodes.end());
+        return num;
+    }
+};
+
+// 把src中[lo, hi)区间的元素的键用f修改后移动到dst中：
+template<typename Map, typename F>
+std::size_t spliceRange(Map& src, Map& dst,
+                        const typename Map::key_type& lo,
+                        const typename Map::key_type& hi,
+                        F f, NodeList<Map>& buf)
+{
+    buf.clear();
+    buf.extract(src, lo, hi);
+    buf.rekey(f);
+    return buf.insertInto(dst);
+}
+
+#endif  // NODESPLICE_HPP
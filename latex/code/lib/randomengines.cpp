@@ -0,0 +1,94 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>    // for shuffle()
+#include <cstdlib>      // for std::atoll()
+#include "randomengines.hpp"
+#include "reservoir.hpp"
+#include "timer.hpp"
+
+// 逐个调用operator()：
+template<typename Engine>
+void benchCall(const std::string& name, long long num)
+{
+    Engine eng;
+    Timer t;
+    std::uint64_t x = 0;
+    for (long long i = 0; i < num; ++i) {
+        x ^= eng();
+    }
+    t.printDiff("  " + name + " operator(): ");
+    std::cout << "    (xor: " << x << ")\n";
+}
+
+// 每次调用fill()生成一块值：
+template<typename Engine>
+void benchFill(const std::string& name, long long num)
+{
+    Engine eng;
+    std::vector<std::uint64_t> buf(4096);
+    Timer t;
+    std::uint64_t x = 0;
+    for (long long i = 0; i < num; i += buf.size()) {
+        eng.fill(buf.data(), buf.size());
+        for (auto v : buf) {    // 和benchCall()一样使用每一个值，编译器不能省略生成的工作
+            x ^= v;
+        }
+    }
+    t.printDiff("  " + name + " fill():       ");
+    std::cout << "    (xor: " << x << ")\n";
+}
+
+int main(int argc, char* argv[])
+{
+    // 这些引擎可以直接用于标准库的算法和分布：
+    std::vector<std::string> coll;
+    for (int i = 0; i < 20; ++i) {
+        coll.push_back("value" + std::to_string(i));
+    }
+    std::shuffle(coll.begin(), coll.end(), Xoshiro256ss{});
+    std::sample(coll.begin(), coll.end(),
+                std::ostream_iterator<std::string>{std::cout, " "},
+                5, Pcg64{});
+    std::cout << '\n';
+    Philox4x32 dice;
+    std::cout << std::uniform_int_distribution<int>{1, 6}(dice) << '\n';
+
+    // 检查jump/split：跳过的值必须和逐个生成的相同
+    Pcg64 p1, p2;
+    p1.discard(1000);
+    for (int i = 0; i < 1000; ++i) {
+        p2();
+    }
+    std::cout << "Pcg64 discard():      " << (p1() == p2() ? "OK" : "ERROR") << '\n';
+    Philox4x32 f1, f2;
+    f1.discard(1001);
+    std::vector<std::uint64_t> buf(1002);
+    f2.fill(buf.data(), buf.size());
+    std::cout << "Philox4x32 discard(): " << (f1() == buf[1001] ? "OK" : "ERROR") << '\n';
+    Xoshiro256ss x1;
+    std::cout << "Xoshiro256ss split(): "
+              << (x1.split(0)() != x1.split(1)() ? "OK" : "ERROR") << '\n';
+
+    // 用在抽样中（每个线程使用一个split()得到的流）：
+    std::vector<int> data(1'000'000);
+    auto idx = parallelSampleIndices<decltype(data.begin()), Xoshiro256ss>(
+                   data.begin(), data.end(), 5, 4);
+    std::cout << "sampled indices:";
+    for (auto i : idx) {
+        std::cout << ' ' << i;
+    }
+    std::cout << '\n';
+
+    long long num = argc > 1 ? std::atoll(argv[1]) : 1'000'000'000;
+    std::cout << "generating " << num << " values:\n";
+    benchCall<std::mt19937_64>("mt19937_64  ", num);
+    benchCall<std::minstd_rand>("minstd_rand ", num);
+    benchCall<Xoshiro256ss>("Xoshiro256ss", num);
+    benchCall<Pcg64>("Pcg64       ", num);
+    benchCall<Philox4x32>("Philox4x32  ", num);
+    benchFill<Xoshiro256ss>("Xoshiro256ss", num);
+    benchFill<Pcg64>("Pcg64       ", num);
+    benchFill<Philox4x32>("Philox4x32  ", num);
+}
@@ -0,0 +1,294 @@
+#ifndef RANDOMENGINES_HPP
+#define RANDOMENGINES_HPP
+
+#include <cstdint>
+#include <cstddef>  // for std::size_t
+#include <limits>
+#ifdef _MSC_VER
+#include <intrin.h> // for __umulh()
+#endif
+
+/********************************************
+* 快速的随机数引擎，都满足UniformRandomBitGenerator的要求：
+* - Xoshiro256ss：xoshiro256**，jump()跳过2^128个值
+* - Pcg64：PCG XSL-RR 128/64，advance()可以跳过任意多个值
+* - Philox4x32：基于计数器的Philox4x32-10，discard()是O(1)的
+* 所有引擎都提供：
+* - split(i)：为第i个线程创建一个不重叠的独立流
+* - fill(out, n)：一次调用生成n个值
+********************************************/
+
+namespace randomengines_detail {
+
+    inline std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    inline std::uint64_t rotr(std::uint64_t x, unsigned k) {
+        return (x >> k) | (x << ((64 - k) & 63));
+    }
+
+    // 用来把一个种子扩展为多个状态字：
+    inline std::uint64_t splitmix64(std::uint64_t& x) {
+        std::uint64_t z = (x += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+    inline std::uint64_t mulhi64(std::uint64_t a, std::uint64_t b) {
+#ifdef _MSC_VER
+        return __umulh(a, b);   // Windows API
+#else
+        return static_cast<std::uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#endif
+    }
+
+    // 最小的128位无符号整数（只提供PCG需要的运算）：
+    struct U128 {
+        std::uint64_t hi, lo;
+        friend U128 operator+ (U128 a, U128 b) {
+            std::uint64_t lo = a.lo + b.lo;
+            return {a.hi + b.hi + (lo < a.lo), lo};
+        }
+        friend U128 operator* (U128 a, U128 b) {
+            return {mulhi64(a.lo, b.lo) + a.hi * b.lo + a.lo * b.hi, a.lo * b.lo};
+        }
+    };
+}
+
+class Xoshiro256ss
+{
+public:
+    using result_type = std::uint64_t;
+    static constexpr result_type default_seed = 0x2545F4914F6CDD1D;
+private:
+    std::uint64_t s[4];
+
+    void jumpWith(const std::uint64_t (&poly)[4]) {
+        std::uint64_t t[4] = {0, 0, 0, 0};
+        for (std::uint64_t p : poly) {
+            for (int b = 0; b < 64; ++b) {
+                if (p & (std::uint64_t{1} << b)) {
+                    for (int i = 0; i < 4; ++i) {
+                        t[i] ^= s[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i) {
+            s[i] = t[i];
+        }
+    }
+public:
+    explicit Xoshiro256ss(result_type seed = default_seed) {
+        for (auto& w : s) {
+            w = randomengines_detail::splitmix64(seed);
+        }
+    }
+    static constexpr result_type min() {
+        return 0;
+    }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator() () {
+        using randomengines_detail::rotl;
+        const std::uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const std::uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+    void fill(result_type* out, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = (*this)();
+        }
+    }
+
+    // 相当于调用2^128次operator()：
+    void jump() {
+        static constexpr std::uint64_t poly[4] = {0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C,
+                                                  0xA9582618E03FC9AA, 0x39ABDC4529B1661C};
+        jumpWith(poly);
+    }
+    // 相当于调用2^192次operator()：
+    void long_jump() {
+        static constexpr std::uint64_t poly[4] = {0x76E15D3EFEFDCBBF, 0xC5004E441C522FB3,
+                                                  0x77710069854EE241, 0x39109BB02ACBE635};
+        jumpWith(poly);
+    }
+    Xoshiro256ss split(unsigned i) const {
+        Xoshiro256ss e{*this};
+        for (unsigned j = 0; j <= i; ++j) {
+            e.jump();
+        }
+        return e;
+    }
+};
+
+class Pcg64
+{
+public:
+    using result_type = std::uint64_t;
+    static constexpr result_type default_seed = 0xCAFEF00DD15EA5E5;
+private:
+    using U128 = randomengines_detail::U128;
+    static constexpr U128 mult{0x2360ED051FC65DA4, 0x4385DF649FCCF645};
+    U128 state;
+    U128 inc;       // 必须是奇数，不同的inc是不同的流
+
+    static result_type output(U128 s) {
+        return randomengines_detail::rotr(s.hi ^ s.lo, static_cast<unsigned>(s.hi >> 58));
+    }
+public:
+    explicit Pcg64(result_type seed = default_seed, result_type stream = 0) {
+        inc = U128{0x5851F42D4C957F2D + stream, 0x14057B7EF767814F};
+        state = U128{0, 0};
+        (*this)();
+        state = state + U128{randomengines_detail::splitmix64(seed), seed};
+        (*this)();
+    }
+    static constexpr result_type min() {
+        return 0;
+    }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator() () {
+        state = state * mult + inc;
+        return output(state);
+    }
+    void fill(result_type* out, std::size_t n) {
+        U128 s = state;     // 在局部变量中计算，避免每次写回成员
+        for (std::size_t i = 0; i < n; ++i) {
+            s = s * mult + inc;
+            out[i] = output(s);
+        }
+        state = s;
+    }
+
+    // 在O(log delta)的时间内跳过delta个值：
+    void advance(U128 delta) {
+        U128 accMult{0, 1}, accPlus{0, 0};
+        U128 curMult = mult, curPlus = inc;
+        while (delta.hi != 0 || delta.lo != 0) {
+            if (delta.lo & 1) {
+                accMult = accMult * curMult;
+                accPlus = accPlus * curMult + curPlus;
+            }
+            curPlus = (curMult + U128{0, 1}) * curPlus;
+            curMult = curMult * curMult;
+            delta = U128{delta.hi >> 1, (delta.lo >> 1) | (delta.hi << 63)};
+        }
+        state = accMult * state + accPlus;
+    }
+    void discard(unsigned long long n) {
+        advance(U128{0, n});
+    }
+    // 相当于调用2^64次operator()：
+    void jump() {
+        advance(U128{1, 0});
+    }
+    // PCG用不同的增量得到不同的流：
+    Pcg64 split(unsigned i) const {
+        Pcg64 e{*this};
+        e.inc = inc + U128{0, 2 * (static_cast<std::uint64_t>(i) + 1)};
+        return e;
+    }
+};
+
+class Philox4x32
+{
+public:
+    using result_type = std::uint64_t;
+    static constexpr result_type default_seed = 20111115;
+private:
+    std::uint32_t key[2];
+    std::uint64_t ctrLo = 0;        // 流内的块计数器
+    std::uint64_t ctrHi = 0;        // 流的编号
+    result_type buf[2];
+    unsigned pos = 2;               // buf中下一个要返回的值
+
+    // 对计数器(lo, hi)进行10轮Philox运算，得到两个64位的值：
+    void block(std::uint64_t lo, std::uint64_t hi, result_type* out) const {
+        std::uint32_t c0 = static_cast<std::uint32_t>(lo), c1 = static_cast<std::uint32_t>(lo >> 32);
+        std::uint32_t c2 = static_cast<std::uint32_t>(hi), c3 = static_cast<std::uint32_t>(hi >> 32);
+        std::uint32_t k0 = key[0], k1 = key[1];
+        for (int r = 0; r < 10; ++r) {
+            std::uint64_t p0 = std::uint64_t{0xD2511F53} * c0;
+            std::uint64_t p1 = std::uint64_t{0xCD9E8D57} * c2;
+            std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1 ^ k0;
+            std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3 ^ k1;
+            c0 = n0;
+            c1 = static_cast<std::uint32_t>(p1);
+            c2 = n2;
+            c3 = static_cast<std::uint32_t>(p0);
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+        }
+        out[0] = (std::uint64_t{c1} << 32) | c0;
+        out[1] = (std::uint64_t{c3} << 32) | c2;
+    }
+public:
+    explicit Philox4x32(result_type seed = default_seed) {
+        auto k = randomengines_detail::splitmix64(seed);
+        key[0] = static_cast<std::uint32_t>(k);
+        key[1] = static_cast<std::uint32_t>(k >> 32);
+    }
+    static constexpr result_type min() {
+        return 0;
+    }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator() () {
+        if (pos == 2) {
+            block(ctrLo++, ctrHi, buf);
+            pos = 0;
+        }
+        return buf[pos++];
+    }
+    // 各个块互相独立，所以循环可以被向量化（例如-O3 -march=native）：
+    void fill(result_type* out, std::size_t n) {
+        std::size_t i = 0;
+        while (i < n && pos < 2) {
+            out[i++] = buf[pos++];
+        }
+        std::uint64_t c = ctrLo;    // 局部的计数器，避免每次写回成员
+        for (; i + 2 <= n; i += 2) {
+            block(c++, ctrHi, out + i);
+        }
+        ctrLo = c;
+        if (i < n) {
+            out[i] = (*this)();
+        }
+    }
+    void discard(unsigned long long n) {
+        while (n > 0 && pos < 2) {
+            ++pos;
+            --n;
+        }
+        ctrLo += n / 2;
+        if (n % 2) {
+            (*this)();
+        }
+    }
+    // 每个流有2^65个值：
+    Philox4x32 split(unsigned i) const {
+        Philox4x32 e{*this};
+        e.ctrHi = ctrHi + i + 1;
+        e.ctrLo = 0;
+        e.pos = 2;
+        return e;
+    }
+};
+
+#endif  // RANDOMENGINES_HPP
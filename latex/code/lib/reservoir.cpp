@@ -0,0 +1,141 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iterator>
+#include <algorithm>    // for minmax_element()
+#include <random>
+#include <cstdlib>      // for std::atoll()
+#include "reservoir.hpp"
+#include "timer.hpp"
+
+// 生成0, 1, 2, ...的随机访问迭代器，不需要在内存中存储输入：
+class CountingIterator {
+private:
+    long long val = 0;
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = long long;
+    using difference_type = long long;
+    using pointer = const long long*;
+    using reference = long long;
+
+    explicit CountingIterator(long long v = 0) : val{v} {
+    }
+    long long operator* () const { return val; }
+    CountingIterator& operator++ () { ++val; return *this; }
+    CountingIterator& operator+= (long long n) { val += n; return *this; }
+    friend long long operator- (CountingIterator a, CountingIterator b) {
+        return a.val - b.val;
+    }
+    friend CountingIterator operator+ (CountingIterator a, long long n) {
+        return a += n;
+    }
+    friend bool operator!= (CountingIterator a, CountingIterator b) {
+        return a.val != b.val;
+    }
+    friend bool operator== (CountingIterator a, CountingIterator b) {
+        return a.val == b.val;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    // 和sample1.cpp一样的输入，但只保存被抽中元素的string_view：
+    std::vector<std::string> coll;
+    for (int i = 0; i < 10000; ++i) {
+        coll.push_back("value" + std::to_string(i));
+    }
+    Reservoir<std::string_view> views{10, 42};
+    views.add(coll.begin(), coll.end(),
+              [] (auto pos) { return std::string_view{*pos}; });
+    for (auto sv : views.sample()) {
+        std::cout << "random elem: " << sv << '\n';
+    }
+
+    // 只能遍历一次的输入流：
+    std::istringstream strm{"the quick brown fox jumps over the lazy dog"};
+    Reservoir<std::string> words{3};
+    words.add(std::istream_iterator<std::string>{strm},
+              std::istream_iterator<std::string>{});
+    std::cout << "words:";
+    for (const auto& w : words.sample()) {
+        std::cout << ' ' << w;
+    }
+    std::cout << '\n';
+
+    // k为0时不会抽中任何元素：
+    Reservoir<int> none{0};
+    none.add(coll.begin(), coll.end(), [] (auto) { return 0; });
+    none.push(1);
+    Reservoir<int> none2{0};
+    none2.push(2);
+    none.merge(none2);
+    WeightedReservoir<int> wnone{0};
+    wnone.push(1, 1.0);
+    wnone.merge(WeightedReservoir<int>{0});
+    std::cout << "k == 0: " << (none.sample().empty() && none.count() == 10002
+                                && wnone.sample().empty() ? "OK" : "ERROR") << '\n';
+
+    // 加权抽样：元素i的权重是i+1
+    WeightedReservoir<int> weighted{5, 7};
+    for (int i = 0; i < 100; ++i) {
+        weighted.push(i, i + 1.0);
+    }
+    std::cout << "weighted:";
+    for (int i : weighted.sample()) {
+        std::cout << ' ' << i;
+    }
+    std::cout << '\n';
+
+    // 检查合并后的结果仍然是等概率的（每个下标的期望次数是2000）：
+    std::vector<int> hits(50);
+    for (int run = 0; run < 20000; ++run) {
+        auto idx = parallelSampleIndices(CountingIterator{0}, CountingIterator{50},
+                                         5, 4, run * 4);
+        for (auto i : idx) {
+            ++hits[i];
+        }
+    }
+    auto [minHits, maxHits] = std::minmax_element(hits.begin(), hits.end());
+    std::cout << "parallel hits per index: " << *minHits << ".." << *maxHits << '\n';
+
+    // 在大量生成的元素上抽样：
+    long long num = argc > 1 ? std::atoll(argv[1]) : 1'000'000'000;
+    std::size_t k = 100;
+    std::cout << "sampling " << k << " of " << num << " items:\n";
+    Timer t;
+    {
+        // Algorithm R：每个元素一个随机数
+        std::vector<long long> res;
+        std::mt19937_64 eng;
+        for (long long i = 0; i < num; ++i) {
+            if (res.size() < k) {
+                res.push_back(i);
+            }
+            else if (auto j = std::uniform_int_distribution<long long>{0, i}(eng);
+                     j < static_cast<long long>(k)) {
+                res[j] = i;
+            }
+        }
+        t.printDiff("  Algorithm R:               ");
+    }
+    {
+        Reservoir<long long> res{k};
+        for (long long i = 0; i < num; ++i) {
+            res.push(i);
+        }
+        t.printDiff("  Algorithm L push():        ");
+    }
+    {
+        Reservoir<long long> res{k};
+        res.add(CountingIterator{0}, CountingIterator{num});
+        t.printDiff("  Algorithm L add() (skip):  ");
+    }
+    {
+        auto idx = parallelSampleIndices(CountingIterator{0}, CountingIterator{num}, k);
+        t.printDiff("  parallelSampleIndices():   ");
+        std::cout << "  got " << idx.size() << " indices\n";
+    }
+}
@@ -0,0 +1,311 @@
+#ifndef RESERVOIR_HPP
+#define RESERVOIR_HPP
+
+#include <vector>
+#include <random>
+#include <cmath>        // for log(), exp(), floor()
+#include <iterator>
+#include <algorithm>    // for shuffle(), push_heap(), pop_heap()
+#include <thread>
+#include <utility>      // for std::move(), std::declval()
+#include <type_traits>
+#include <limits>
+
+/********************************************
+* 蓄水池抽样：从长度未知的输入中等概率地抽取k个元素
+* - Reservoir使用Algorithm L：不需要为每个元素生成随机数，
+*   而是直接计算要跳过多少个元素
+* - WeightedReservoir使用A-ExpJ进行加权抽样
+* - 可以合并多个线程各自的蓄水池
+* 保存的元素类型由调用者决定（例如下标或者string_view），以避免拷贝
+********************************************/
+
+template<typename T, typename Engine = std::mt19937_64>
+class Reservoir
+{
+private:
+    std::size_t k;
+    std::vector<T> items;
+    unsigned long long seen = 0;    // 已经处理过的元素数量
+    unsigned long long next = 0;    // 下一个要放入蓄水池的元素的序号
+    double w = 0;
+    Engine eng;
+
+    double uniform() {
+        // (0, 1)区间内的随机数，避免log(0)：
+        return std::uniform_real_distribution<double>{
+                   std::nextafter(0.0, 1.0), 1.0}(eng);
+    }
+    // w是目前所有元素的随机key中第k小的值，被跳过的元素数量服从几何分布：
+    void computeNext() {
+        next += static_cast<unsigned long long>(
+                    std::floor(std::log(uniform()) / std::log1p(-w))) + 1;
+    }
+    void replace(T item) {
+        items[std::uniform_int_distribution<std::size_t>{0, k - 1}(eng)] = std::move(item);
+        w *= std::exp(std::log(uniform()) / k);
+        computeNext();
+    }
+public:
+    Reservoir(std::size_t num, typename Engine::result_type seed = Engine::default_seed)
+     : k{num}, eng{seed} {
+        items.reserve(k);
+    }
+    Reservoir(std::size_t num, Engine e)
+     : k{num}, eng{std::move(e)} {
+        items.reserve(k);
+    }
+
+    // 需要跳过多少个元素才会有下一个被抽中的元素：
+    // （k为0时永远不会抽中任何元素）
+    unsigned long long skip() const {
+        if (k == 0) {
+            return std::numeric_limits<unsigned long long>::max();
+        }
+        return seen < k ? 0 : next - seen;
+    }
+
+    // 逐个地添加元素（只有被抽中的元素才会进行随机数计算）：
+    void push(T item) {
+        if (k == 0) {
+            ++seen;
+            return;
+        }
+        if (seen < k) {
+            items.push_back(std::move(item));
+            if (++seen == k) {
+                w = std::exp(std::log(uniform()) / k);
+                next = k - 1;
+                computeNext();
+            }
+        }
+        else if (seen++ == next) {
+            replace(std::move(item));
+        }
+    }
+
+    // 通过调用proj(pos)为每个被抽中的位置生成要保存的元素（例如下标或者string_view），
+    // 对于非随机访问的迭代器，被跳过的元素只需要递增迭代器：
+    template<typename InputIt, typename Proj>
+    void add(InputIt first, InputIt last, Proj proj) {
+        if (k == 0) {
+            for (; first != last; ++first) {
+                ++seen;
+            }
+            return;
+        }
+        while (seen < k && first != last) {
+            push(proj(first));
+            ++first;
+        }
+        while (first != last) {
+            auto n = next - seen;
+            if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+                              typename std::iterator_traits<InputIt>::iterator_category>) {
+                if (static_cast<unsigned long long>(last - first) <= n) {
+                    seen += last - first;
+                    return;
+                }
+                first += n;
+                seen += n;
+            }
+            else {
+                for (; n > 0 && first != last; --n, ++first) {
+                    ++seen;
+                }
+                if (first == last) {
+                    return;
+                }
+            }
+            ++seen;
+            replace(proj(first));
+            ++first;
+        }
+    }
+    template<typename InputIt>
+    void add(InputIt first, InputIt last) {
+        add(first, last, [] (const InputIt& pos) { return *pos; });
+    }
+
+    const std::vector<T>& sample() const {
+        return items;
+    }
+    unsigned long long count() const {
+        return seen;
+    }
+
+    // 合并另一个（不相交的输入上的）蓄水池，结果仍然是等概率的抽样：
+    void merge(Reservoir other) {
+        std::shuffle(items.begin(), items.end(), eng);
+        std::shuffle(other.items.begin(), other.items.end(), eng);
+        std::vector<T> result;
+        result.reserve(k);
+        unsigned long long n1 = seen, n2 = other.seen;
+        std::size_t i1 = 0, i2 = 0;
+        while (result.size() < k && (i1 < items.size() || i2 < other.items.size())) {
+            // 按照两个输入剩余的大小决定从哪一个中取元素：
+            bool fromThis = i2 == other.items.size()
+                || (i1 < items.size()
+                    && std::uniform_real_distribution<double>{0, 1}(eng) * (n1 + n2) < n1);
+            if (fromThis) {
+                result.push_back(std::move(items[i1++]));
+                --n1;
+            }
+            else {
+                result.push_back(std::move(other.items[i2++]));
+                --n2;
+            }
+        }
+        items.swap(result);
+        seen += other.seen;
+        if (k > 0 && items.size() == k) {
+            // 第k小的key服从Beta(k, n-k+1)分布：
+            double x = std::gamma_distribution<double>{double(k)}(eng);
+            double y = std::gamma_distribution<double>{double(seen - k + 1)}(eng);
+            w = x / (x + y);
+            next = seen - 1;
+            computeNext();
+        }
+    }
+};
+
+template<typename T, typename Engine = std::mt19937_64>
+class WeightedReservoir
+{
+private:
+    struct Entry {
+        double key;     // log(u) / weight，越大越好
+        T item;
+        bool operator< (const Entry& e) const {
+            return key > e.key;     // 堆顶是key最小的元素
+        }
+    };
+    std::size_t k;
+    std::vector<Entry> heap;
+    double jump = 0;                // 还需要跳过的权重
+    Engine eng;
+
+    double uniform() {
+        return std::uniform_real_distribution<double>{
+                   std::nextafter(0.0, 1.0), 1.0}(eng);
+    }
+    void computeJump() {
+        // 指数跳跃：跳过的权重之和服从以最小key为参数的指数分布：
+        jump = std::log(uniform()) / heap.front().key;
+    }
+public:
+    WeightedReservoir(std::size_t num, typename Engine::result_type seed = Engine::default_seed)
+     : k{num}, eng{seed} {
+        heap.reserve(k);
+    }
+
+    void push(T item, double weight) {
+        if (weight <= 0 || k == 0) {
+            return;
+        }
+        if (heap.size() < k) {
+            heap.push_back(Entry{std::log(uniform()) / weight, std::move(item)});
+            std::push_heap(heap.begin(), heap.end());
+            if (heap.size() == k) {
+                computeJump();
+            }
+            return;
+        }
+        jump -= weight;
+        if (jump > 0) {
+            return;
+        }
+        // 新的key必须大于当前最小的key：
+        double tw = std::exp(heap.front().key * weight);
+        double r = std::uniform_real_distribution<double>{tw, 1.0}(eng);
+        std::pop_heap(heap.begin(), heap.end());
+        heap.back() = Entry{std::log(r) / weight, std::move(item)};
+        std::push_heap(heap.begin(), heap.end());
+        computeJump();
+    }
+
+    // 加权抽样的合并只需要保留key最大的k个元素：
+    void merge(WeightedReservoir other) {
+        if (k == 0) {
+            return;
+        }
+        for (auto& e : other.heap) {
+            if (heap.size() < k) {
+                heap.push_back(std::move(e));
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else if (e.key > heap.front().key) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = std::move(e);
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        if (heap.size() == k) {
+            computeJump();
+        }
+    }
+
+    std::vector<T> sample() const {
+        std::vector<T> result;
+        for (const auto& e : heap) {
+            result.push_back(e.item);
+        }
+        return result;
+    }
+};
+
+// 为第i个线程创建引擎：
+// 支持split()的引擎（见randomengines.hpp）使用不重叠的独立流，其他的引擎使用不同的种子
+template<typename Engine, typename = void>
+struct HasSplit : std::false_type {
+};
+template<typename Engine>
+struct HasSplit<Engine, std::void_t<decltype(std::declval<const Engine&>().split(0u))>>
+ : std::true_type {
+};
+
+template<typename Engine>
+Engine threadEngine(typename Engine::result_type seed, unsigned i)
+{
+    if constexpr (HasSplit<Engine>::value) {
+        return Engine{seed}.split(i);
+    }
+    else {
+        return Engine(seed + i);
+    }
+}
+
+// 把[first, last)分块并行地抽样，返回被抽中元素的下标：
+template<typename RandomIt, typename Engine = std::mt19937_64>
+std::vector<std::size_t> parallelSampleIndices(RandomIt first, RandomIt last,
+                                               std::size_t k,
+                                               unsigned numThreads = std::thread::hardware_concurrency(),
+                                               typename Engine::result_type seed = Engine::default_seed)
+{
+    using Res = Reservoir<std::size_t, Engine>;
+    std::size_t total = last - first;
+    numThreads = std::max(1u, numThreads);
+    std::vector<Res> parts;
+    for (unsigned i = 0; i < numThreads; ++i) {
+        parts.emplace_back(k, threadEngine<Engine>(seed, i));
+    }
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&, i] {
+            auto begin = first + total * i / numThreads;
+            auto end = first + total * (i + 1) / numThreads;
+            parts[i].add(begin, end, [first] (const RandomIt& pos) {
+                                         return static_cast<std::size_t>(pos - first);
+                                     });
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    for (unsigned i = 1; i < numThreads; ++i) {
+        parts[0].merge(std::move(parts[i]));
+    }
+    return parts[0].sample();
+}
+
+#endif  // RESERVOIR_HPP
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <array>
+#include <cstddef>      // for std::byte
+#include <cstdlib>      // for std::atoi()
+#include <memory_resource>
+#include <sstream>
+#include <iterator>     // for std::istream_iterator
+#include "ifcomptime.hpp"
+#include "asstring.hpp"
+#include "../lib/timer.hpp"
+
+int main(int argc, char* argv[])
+{
+    std::cout << fastconv::asString(42) << '\n';
+    std::cout << fastconv::asString(std::string("hello")) << '\n';
+    std::cout << fastconv::asString("hello") << '\n';
+    std::cout << fastconv::asString(0.1) << " (std::to_string(): "
+              << asString(0.1) << ")\n";
+    std::cout << fastconv::asString('A') << " (std::to_string(): "
+              << asString('A') << ")\n";
+
+    // 写入调用者的缓冲区：
+    char buf[fastconv::maxLength<long long>];
+    char* end = fastconv::asStringTo(buf, buf + sizeof(buf), -1234567890123LL);
+    std::cout << std::string_view(buf, end - buf) << '\n';
+
+    // 写入栈上的内存池：
+    std::array<std::byte, 1000> mem;
+    std::pmr::monotonic_buffer_resource pool{mem.data(), mem.size()};
+    std::pmr::string ps = fastconv::asString(3.14159265358979, &pool);
+    std::cout << ps << '\n';
+
+    // 一千万次混合的转换：
+    int num = argc > 1 ? std::atoi(argv[1]) : 10'000'000;
+    std::vector<int> ints(num / 2);
+    std::vector<double> doubles(num - num / 2);
+    for (int i = 0; i < num / 2; ++i) {
+        ints[i] = i * 7919;
+    }
+    for (std::size_t i = 0; i < doubles.size(); ++i) {
+        doubles[i] = i * 0.37;
+    }
+
+    Timer t;
+    std::size_t len = 0;
+    for (int i : ints) {
+        len += asString(i).size();
+    }
+    for (double d : doubles) {
+        len += asString(d).size();
+    }
+    t.printDiff("asString() with to_string():   ");
+    std::cout << "  " << len << " chars\n";
+
+    len = 0;
+    for (int i : ints) {
+        len += fastconv::asString(i).size();
+    }
+    for (double d : doubles) {
+        len += fastconv::asString(d).size();
+    }
+    t.printDiff("fastconv::asString():          ");
+    std::cout << "  " << len << " chars\n";
+
+    len = 0;
+    char tmp[fastconv::maxLength<double>];
+    for (int i : ints) {
+        len += fastconv::asStringTo(tmp, tmp + sizeof(tmp), i) - tmp;
+    }
+    for (double d : doubles) {
+        len += fastconv::asStringTo(tmp, tmp + sizeof(tmp), d) - tmp;
+    }
+    t.printDiff("fastconv::asStringTo():        ");
+    std::cout << "  " << len << " chars\n";
+
+    std::string all;
+    std::vector<std::string_view> views;
+    fastconv::asStringBatch(ints.begin(), ints.end(), all, views);
+    len = all.size();
+    fastconv::asStringBatch(doubles.begin(), doubles.end(), all, views);
+    len += all.size();
+    t.printDiff("fastconv::asStringBatch():     ");
+    std::cout << "  " << len << " chars\n";
+
+    // 输入迭代器只能遍历一次，所以逐个元素扩容：
+    std::istringstream in{"1 22 333 -4444"};
+    fastconv::asStringBatch(std::istream_iterator<int>{in}, std::istream_iterator<int>{},
+                            all, views);
+    std::cout << "from istream: " << all << ", " << views.size() << " values, "
+              << (views.size() == 4 && views[3] == "-4444" ? "OK" : "ERROR") << '\n';
+}
@@ -0,0 +1,145 @@
+#ifndef ASSTRING_HPP
+#define ASSTRING_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>         // for to_chars()
+#include <memory_resource>
+#include <vector>
+#include <iterator>         // for std::distance()
+#include <algorithm>        // for std::copy()
+#include <type_traits>
+#include <limits>
+
+/********************************************
+* 和ifcomptime.hpp中的asString()相同的编译期分发，但是：
+* - 数字通过to_chars()转换（与locale无关，浮点数使用最短的表示）
+* - 每种算术类型在编译期确定最大长度，字符串只需分配一次
+* - 可以写入调用者的缓冲区或者std::pmr::string
+* - asStringBatch()把一个区间的所有值写入同一个缓冲区
+* 注意：std::to_string(double)总是输出6位小数，而这里输出最短的精确表示；
+*      char被作为字符转换（'A'转换为"A"，而ifcomptime.hpp中的asString()得到"65"），
+*      signed char和unsigned char仍然作为数字转换
+********************************************/
+
+namespace fastconv {
+
+    // 转换后的最大长度（对于字符串类型在运行期计算）：
+    template<typename T>
+    constexpr std::size_t maxLengthOf() {
+        if constexpr (std::is_same_v<T, bool> || std::is_same_v<T, char>) {
+            return 1;
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            return std::numeric_limits<T>::digits10 + 2;    // 符号和多出的一位
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            // 符号、最多max_digits10位有效数字、小数点、指数：
+            return std::numeric_limits<T>::max_digits10 + 8;
+        }
+        else {
+            return 0;
+        }
+    }
+    template<typename T>
+    constexpr std::size_t maxLength = maxLengthOf<T>();
+
+    // 写入[first, last)，返回写入的末尾（空间不够时返回nullptr）：
+    template<typename T>
+    char* asStringTo(char* first, char* last, const T& x)
+    {
+        if constexpr (std::is_same_v<T, char> || std::is_same_v<T, bool>) {
+            if (first == last) {
+                return nullptr;
+            }
+            *first = std::is_same_v<T, bool> ? (x ? '1' : '0') : x;
+            return first + 1;
+        }
+        else if constexpr (std::is_arithmetic_v<T>) {
+            auto res = std::to_chars(first, last, x);
+            return res.ec == std::errc{} ? res.ptr : nullptr;
+        }
+        else {
+            std::string_view sv{x};     // 如果不能转换为string_view该语句将无效
+            if (static_cast<std::size_t>(last - first) < sv.size()) {
+                return nullptr;
+            }
+            return std::copy(sv.begin(), sv.end(), first);
+        }
+    }
+
+    // 转换为任意的basic_string（例如std::pmr::string）：
+    template<typename Str, typename T>
+    Str asStringAs(const T& x, typename Str::allocator_type alloc = {})
+    {
+        if constexpr (std::is_same_v<T, Str>) {
+            return x;
+        }
+        else if constexpr (std::is_arithmetic_v<T>) {
+            char buf[maxLength<T>];     // 在栈上格式化，然后只分配一次
+            auto end = asStringTo(buf, buf + sizeof(buf), x);
+            return Str(buf, end - buf, alloc);
+        }
+        else {
+            std::string_view sv{x};
+            return Str(sv.data(), sv.size(), alloc);
+        }
+    }
+
+    template<typename T>
+    std::string asString(const T& x)
+    {
+        return asStringAs<std::string>(x);
+    }
+
+    template<typename T>
+    std::pmr::string asString(const T& x, std::pmr::memory_resource* mr)
+    {
+        return asStringAs<std::pmr::string>(x, mr);
+    }
+
+    // 把[first, last)中的所有值转换到同一个缓冲区buf中，
+    // views中的第i个元素指向第i个值的结果：
+    template<typename InputIt>
+    void asStringBatch(InputIt first, InputIt last,
+                       std::string& buf, std::vector<std::string_view>& views)
+    {
+        using T = typename std::iterator_traits<InputIt>::value_type;
+        using Category = typename std::iterator_traits<InputIt>::iterator_category;
+        // 只有前向迭代器才能预先计算元素个数（输入迭代器只能遍历一次）：
+        constexpr bool preallocate = std::is_arithmetic_v<T>
+                                     && std::is_base_of_v<std::forward_iterator_tag, Category>;
+        std::vector<std::size_t> ends;
+        if constexpr (preallocate) {
+            // 根据编译期的最大长度只分配一次：
+            auto num = static_cast<std::size_t>(std::distance(first, last));
+            buf.resize(num * maxLength<T>);
+            ends.reserve(num);
+        }
+        std::size_t used = 0;
+        for (; first != last; ++first) {
+            if constexpr (std::is_arithmetic_v<T>) {
+                if constexpr (!preallocate) {
+                    buf.resize(used + maxLength<T>);    // 每个元素扩容一次（均摊常数时间）
+                }
+            }
+            else {
+                buf.resize(used + std::string_view{*first}.size());
+            }
+            char* end = asStringTo(buf.data() + used, buf.data() + buf.size(), *first);
+            used = end - buf.data();
+            ends.push_back(used);
+        }
+        buf.resize(used);
+        // 缓冲区不再变化之后才创建string_view：
+        views.clear();
+        views.reserve(ends.size());
+        std::size_t begin = 0;
+        for (auto e : ends) {
+            views.emplace_back(buf.data() + begin, e - begin);
+            begin = e;
+        }
+    }
+}
+
+#endif  // ASSTRING_HPP
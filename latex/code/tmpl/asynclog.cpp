@@ -0,0 +1,121 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <cstdlib>      // for std::atoi()
+#include "asynclog.hpp"
+
+// 收集输出，用于检查顺序：
+std::string captured;
+void captureSink(const char* data, std::size_t size)
+{
+    captured.append(data, size);
+}
+void nullSink(const char*, std::size_t)
+{
+}
+
+// 每个线程的消息必须按照发送的顺序出现：
+bool checkOrdering(int numThreads, int perThread)
+{
+    captured.clear();
+    AsyncLogger::instance().setSink(&captureSink);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([t, perThread] {
+            for (int i = 0; i < perThread; ++i) {
+                asyncPrint("thread", t, "seq", i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    AsyncLogger::instance().flush();
+
+    std::vector<int> next(numThreads, 0);
+    std::istringstream in{captured};
+    std::string word1, word2;
+    int t, seq;
+    while (in >> word1 >> t >> word2 >> seq) {
+        if (seq != next[t]++) {
+            return false;
+        }
+    }
+    for (int n : next) {
+        if (n != perThread) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    asyncPrint("hello", 42, 3.14);
+    asyncPrint<'-'>(1, 2, 3);
+    AsyncLogger::instance().flush();
+
+    std::cout << "ordering: " << (checkOrdering(8, 100000) ? "OK" : "ERROR") << '\n';
+
+    // 不同的溢出策略下每次调用的开销：
+    int perThread = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+    AsyncLogger::instance().setSink(&nullSink);
+    for (auto [policy, name] : {std::pair{AsyncLogger::Overflow::block, "block"},
+                                std::pair{AsyncLogger::Overflow::count, "count"}}) {
+        AsyncLogger::instance().setOverflow(policy);
+        for (int numThreads = 1; numThreads <= 32; numThreads *= 2) {
+            std::vector<std::thread> threads;
+            std::vector<double> nsPerCall(numThreads);
+            auto droppedBefore = AsyncLogger::instance().droppedTotal();
+            for (int t = 0; t < numThreads; ++t) {
+                threads.emplace_back([&, t] {
+                    auto start = std::chrono::steady_clock::now();
+                    for (int i = 0; i < perThread; ++i) {
+                        asyncPrint("request", i, "took", i * 0.5, "ms");
+                    }
+                    std::chrono::duration<double, std::nano> d{
+                        std::chrono::steady_clock::now() - start};
+                    nsPerCall[t] = d.count() / perThread;
+                });
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+            AsyncLogger::instance().flush();
+            double sum = 0;
+            for (double ns : nsPerCall) {
+                sum += ns;
+            }
+            std::cout << name << ", " << numThreads << " producers: "
+                      << sum / numThreads << " ns per call";
+            // count策略的开销很低只是因为大部分消息被丢弃了：
+            auto dropped = AsyncLogger::instance().droppedTotal() - droppedBefore;
+            if (policy == AsyncLogger::Overflow::count) {
+                std::cout << ", " << dropped << " of "
+                          << static_cast<long long>(numThreads) * perThread << " dropped ("
+                          << 100.0 * dropped / (static_cast<double>(numThreads) * perThread)
+                          << "%)";
+            }
+            std::cout << '\n';
+        }
+    }
+
+    // 突发的消息（每次不超过缓冲区的大小）：block策略也不需要等待，也不会丢弃任何消息
+    AsyncLogger::instance().setOverflow(AsyncLogger::Overflow::block);
+    constexpr int burst = 512;
+    double ns = 0;
+    for (int b = 0; b < perThread / burst; ++b) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < burst; ++i) {
+            asyncPrint("request", i, "took", i * 0.5, "ms");
+        }
+        std::chrono::duration<double, std::nano> d{std::chrono::steady_clock::now() - start};
+        ns += d.count();
+        AsyncLogger::instance().flush();    // 不计时：等待后台线程处理完这一批
+    }
+    std::cout << "block, bursts of " << burst << " messages: "
+              << ns / (perThread / burst * burst) << " ns per call\n";
+}
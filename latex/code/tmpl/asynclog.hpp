@@ -0,0 +1,233 @@
+#ifndef ASYNCLOG_HPP
+#define ASYNCLOG_HPP
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <memory>       // for std::shared_ptr
+#include <utility>      // for std::pair
+#include <tuple>
+#include <string>
+#include <new>          // for placement new
+#include <cstddef>      // for std::max_align_t
+#include <type_traits>
+#include <cstdio>       // for fwrite()
+#include <chrono>
+#include "fastprint.hpp"
+
+/********************************************
+* AsyncLogger：异步的print<Sep>()
+* - 生产者线程只把未格式化的参数（trivially copyable）和
+*   格式化函数的指针放入本线程的SPSC环形缓冲区
+* - 后台线程批量地格式化（使用fastprint.hpp）并写出
+* - 缓冲区满时的策略：阻塞、丢弃或者丢弃并计数，droppedTotal()返回丢弃的消息总数
+* 开销：缓冲区不满时，一次调用只是拷贝参数和两次原子操作（几十纳秒）；
+*      但是持续记录时，后台线程每秒只能格式化有限数量的消息：
+*      - block：缓冲区满了之后生产者必须等待，每次调用的开销等于后台线程处理一条消息的时间
+*        乘以生产者的数量（例如一个生产者几百纳秒，32个生产者几微秒）
+*      - drop/count：调用仍然很快，但是超出后台线程处理能力的消息都被丢弃
+*      所以几十纳秒的开销只适用于突发的（每个线程不超过缓冲区大小的）消息，
+*      或者允许丢弃消息的场合
+* 保证：同一个线程的消息按照调用的顺序写出；
+*      不同线程之间的消息没有顺序保证
+* 注意：const char*和string_view参数只被拷贝指针，
+*      所以它们指向的字符串必须在写出之前一直有效（例如字符串字面量）
+********************************************/
+
+class AsyncLogger
+{
+public:
+    enum class Overflow { block, drop, count };
+    using Sink = void (*)(const char* data, std::size_t size);
+private:
+    using FormatFn = void (*)(std::string& out, const void* args);
+
+    struct Record {
+        FormatFn format;
+        alignas(std::max_align_t) unsigned char args[112];
+    };
+
+    // 单生产者单消费者的环形缓冲区：
+    struct Ring {
+        static constexpr std::size_t capacity = 1024;   // 必须是2的幂
+        Record records[capacity];
+        alignas(64) std::atomic<std::size_t> head{0};  // 只被消费者修改
+        alignas(64) std::atomic<std::size_t> tail{0};  // 只被生产者修改
+        std::atomic<bool> retired{false};               // 生产者线程已经结束
+    };
+
+    // 线程结束时标记它的缓冲区，后台线程写出剩余的消息后再释放它：
+    struct RingHandle {
+        std::shared_ptr<Ring> ring;
+        ~RingHandle() {
+            if (ring) {
+                ring->retired = true;
+            }
+        }
+    };
+
+    std::mutex ringsMx;                         // 生产者只在第一次调用时使用
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::atomic<Overflow> overflow{Overflow::block};
+    std::atomic<Sink> sink{&writeStdout};
+    std::atomic<unsigned long long> dropped{0};         // 还没有报告的丢弃数
+    std::atomic<unsigned long long> droppedSum{0};      // 所有丢弃的消息数
+    std::atomic<bool> done{false};
+    std::thread worker;
+
+    static void writeStdout(const char* data, std::size_t size) {
+        std::fwrite(data, 1, size, stdout);
+        std::fflush(stdout);
+    }
+
+    template<auto Sep, typename... Args>
+    static void formatRecord(std::string& out, const void* p) {
+        const auto& args = *static_cast<const std::tuple<Args...>*>(p);
+        std::apply([&] (const auto&... a) {
+                       fastprint_detail::format<Sep>(out, a...);
+                   }, args);
+    }
+
+    Ring& threadRing() {
+        thread_local RingHandle handle;
+        if (!handle.ring) {
+            handle.ring = std::make_shared<Ring>();
+            std::lock_guard lg{ringsMx};
+            rings.push_back(handle.ring);
+        }
+        return *handle.ring;
+    }
+
+    // 后台线程：轮询所有的缓冲区，一批消息只写一次
+    void run() {
+        std::string batch;
+        std::vector<std::shared_ptr<Ring>> local;
+        std::vector<std::size_t> newHeads;
+        for (;;) {
+            bool stop = done.load();
+            {
+                std::lock_guard lg{ringsMx};
+                local = rings;
+            }
+            newHeads.clear();
+            std::size_t num = 0;
+            for (auto& r : local) {
+                auto head = r->head.load(std::memory_order_relaxed);
+                auto tail = r->tail.load(std::memory_order_acquire);
+                for (; head != tail; ++head) {
+                    const Record& rec = r->records[head % Ring::capacity];
+                    rec.format(batch, rec.args);
+                    ++num;
+                }
+                newHeads.push_back(head);
+            }
+            if (auto d = dropped.exchange(0); d > 0) {
+                batch += "[" + std::to_string(d) + " messages dropped]\n";
+            }
+            if (!batch.empty()) {
+                sink.load()(batch.data(), batch.size());
+                batch.clear();
+            }
+            // 写出之后才释放缓冲区中的位置（flush()依赖于此）：
+            for (std::size_t i = 0; i < local.size(); ++i) {
+                local[i]->head.store(newHeads[i], std::memory_order_release);
+            }
+            // 删除已经结束并且已经清空的缓冲区：
+            {
+                std::lock_guard lg{ringsMx};
+                for (auto pos = rings.begin(); pos != rings.end(); ) {
+                    if ((*pos)->retired && (*pos)->head == (*pos)->tail) {
+                        pos = rings.erase(pos);
+                    }
+                    else {
+                        ++pos;
+                    }
+                }
+            }
+            if (num == 0) {
+                if (stop) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+    }
+
+    AsyncLogger() : worker{[this] { run(); }} {
+    }
+public:
+    static AsyncLogger& instance() {
+        static AsyncLogger logger;
+        return logger;
+    }
+    ~AsyncLogger() {
+        done = true;
+        worker.join();
+    }
+
+    void setOverflow(Overflow o) {
+        overflow = o;
+    }
+    void setSink(Sink s) {
+        sink = s;
+    }
+    // drop和count策略下丢弃的消息总数：
+    unsigned long long droppedTotal() const {
+        return droppedSum.load();
+    }
+
+    template<auto Sep = ' ', typename... Args>
+    void log(const Args&... args) {
+        using Tuple = std::tuple<std::decay_t<const Args&>...>;
+        static_assert((... && std::is_trivially_copyable_v<std::decay_t<const Args&>>),
+                      "only trivially copyable arguments can be logged asynchronously");
+        static_assert(sizeof(Tuple) <= sizeof(Record::args), "too many arguments");
+
+        Ring& r = threadRing();
+        auto tail = r.tail.load(std::memory_order_relaxed);
+        while (tail - r.head.load(std::memory_order_acquire) == Ring::capacity) {
+            // 缓冲区已满：
+            switch (overflow.load(std::memory_order_relaxed)) {
+                case Overflow::drop:
+                    droppedSum.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case Overflow::count:
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    droppedSum.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                case Overflow::block:
+                    std::this_thread::yield();
+                    break;
+            }
+        }
+        Record& rec = r.records[tail % Ring::capacity];
+        rec.format = &formatRecord<Sep, std::decay_t<const Args&>...>;
+        ::new (static_cast<void*>(rec.args)) Tuple{args...};
+        r.tail.store(tail + 1, std::memory_order_release);
+    }
+
+    // 等待所有已经提交的消息被写出：
+    void flush() {
+        std::vector<std::pair<std::shared_ptr<Ring>, std::size_t>> pending;
+        {
+            std::lock_guard lg{ringsMx};
+            for (auto& r : rings) {
+                pending.emplace_back(r, r->tail.load());
+            }
+        }
+        for (auto& [r, tail] : pending) {
+            while (r->head.load() < tail) {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+    }
+};
+
+template<auto Sep = ' ', typename... Args>
+void asyncPrint(const Args&... args)
+{
+    AsyncLogger::instance().log<Sep>(args...);
+}
+
+#endif  // ASYNCLOG_HPP
@@ -0,0 +1,65 @@
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>      // for std::atoi()
+#include "fastprint.hpp"
+#include "printauto.hpp"
+
+// 计时结果写到cerr，这样可以把标准输出重定向到/dev/null：
+template<typename F>
+void measure(const char* name, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::cout.flush();
+    std::fflush(stdout);
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    std::cerr << name << diff.count() << "ms\n";
+}
+
+int main(int argc, char* argv[])
+{
+    std::string s{"hello"};
+    fastPrint(1, 2.5, s, 'x', "literal", -7LL);
+    fastPrint<'-'>(1, 2, 3);
+    print<'-'>(1, 2, 3);
+    std::uint8_t u8 = 65;
+    fastPrint(u8, static_cast<signed char>('B'), 123456789.0, 0.1 + 0.2, 1e-10f);  // 和下一行相同
+    print(u8, static_cast<signed char>('B'), 123456789.0, 0.1 + 0.2, 1e-10f);
+
+    int num = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+    measure("print<>():         ", [&] {
+        for (int i = 0; i < num; ++i) {
+            print("request", i, "took", i * 0.001, "ms from", s);
+        }
+    });
+    measure("fastPrint<>():     ", [&] {
+        for (int i = 0; i < num; ++i) {
+            fastPrint("request", i, "took", i * 0.001, "ms from", s);
+        }
+    });
+    measure("bufferedPrint<>(): ", [&] {
+        for (int i = 0; i < num; ++i) {
+            bufferedPrint("request", i, "took", i * 0.001, "ms from", s);
+        }
+        flushPrintBuffer();
+    });
+
+    // 多个线程使用各自的缓冲区，互相之间不需要加锁：
+    measure("4 threads bufferedPrint<>(): ", [&] {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < num / 4; ++i) {
+                    bufferedPrint("thread", t, "value", i);
+                }
+            }); // 线程结束时自动写出剩余的输出
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    });
+}
@@ -0,0 +1,164 @@
+#ifndef FASTPRINT_HPP
+#define FASTPRINT_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>     // for to_chars()
+#include <sstream>
+#include <limits>
+#include <type_traits>
+#include <cstdio>       // for fwrite()
+
+/********************************************
+* fastPrint<Sep>(args...)：和printauto.hpp中的print<Sep>()用法相同，
+* 但是所有参数先被格式化到一个thread_local的缓冲区中：
+* - 整数和浮点数使用to_chars()（与locale无关），输出和operator<<的默认格式相同：
+*   char、signed char、unsigned char（包括int8_t和uint8_t）作为字符输出，
+*   浮点数和%g一样保留6位有效数字（123456789.0输出为1.23457e+08）
+* - 编译期计算算术类型的最大长度，缓冲区只需要扩容一次
+* - 每次调用只写一次
+* bufferedPrint<Sep>(args...)只写入当前线程的缓冲区，
+* 缓冲区满了、调用flushPrintBuffer()或者线程结束时才写出，不需要任何锁
+********************************************/
+
+namespace fastprint_detail {
+
+    // operator<<把这些类型作为字符输出：
+    template<typename T>
+    constexpr bool isCharLike = std::is_same_v<T, char> || std::is_same_v<T, signed char>
+                                || std::is_same_v<T, unsigned char>;
+
+    // 算术类型格式化后的最大长度：
+    template<typename T>
+    constexpr std::size_t maxLength() {
+        if constexpr (std::is_same_v<T, bool> || isCharLike<T>) {
+            return 1;
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            return std::numeric_limits<T>::digits10 + 2;    // 符号和多出的一位
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            // 符号、6位有效数字、小数点、指数（例如-1.23457e+308）：
+            return 6 + 10;
+        }
+        else {
+            return 0;
+        }
+    }
+
+    // 参数的长度上限（编译期或者运行期）：
+    template<typename T>
+    std::size_t sizeBound(const T& arg) {
+        if constexpr (std::is_arithmetic_v<T>) {
+            return maxLength<T>();
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            return std::string_view{arg}.size();
+        }
+        else {
+            return 32;  // 只是一个猜测
+        }
+    }
+
+    class PrintBuffer {
+    private:
+        std::string buf;
+    public:
+        static constexpr std::size_t flushLimit = 64 * 1024;
+
+        ~PrintBuffer() {
+            flush();
+        }
+        std::string& data() {
+            return buf;
+        }
+        void flush() {
+            if (!buf.empty()) {
+                std::fwrite(buf.data(), 1, buf.size(), stdout);
+                buf.clear();
+            }
+        }
+    };
+
+    inline PrintBuffer& threadBuffer() {
+        thread_local PrintBuffer pb;    // 每个线程一个
+        return pb;
+    }
+
+    // 把一个参数追加到buf中：
+    template<typename T>
+    void append(std::string& buf, const T& arg) {
+        if constexpr (isCharLike<T>) {
+            buf.push_back(static_cast<char>(arg));
+        }
+        else if constexpr (std::is_same_v<T, bool>) {
+            buf.push_back(arg ? '1' : '0');     // 和operator<<的默认行为一样
+        }
+        else if constexpr (std::is_integral_v<T>) {
+            // 直接格式化到字符串末尾的空闲空间中：
+            auto old = buf.size();
+            buf.resize(old + maxLength<T>());
+            auto res = std::to_chars(buf.data() + old, buf.data() + buf.size(), arg);
+            buf.resize(res.ptr - buf.data());
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            // 和operator<<的默认格式（%g，精度6）一样：
+            auto old = buf.size();
+            buf.resize(old + maxLength<T>());
+            auto res = std::to_chars(buf.data() + old, buf.data() + buf.size(), arg,
+                                     std::chars_format::general, 6);
+            buf.resize(res.ptr - buf.data());
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+            buf.append(std::string_view{arg});
+        }
+        else {
+            // 其他类型仍然使用operator<<：
+            thread_local std::ostringstream strm;
+            strm.str("");
+            strm << arg;
+            buf.append(strm.str());
+        }
+    }
+
+    template<auto Sep, typename First, typename... Args>
+    void format(std::string& buf, const First& first, const Args&... args) {
+        buf.reserve(buf.size() + sizeBound(first)
+                    + (... + (sizeBound(args) + 1)) + 1);
+        append(buf, first);
+        (... , (append(buf, Sep), append(buf, args)));
+        buf.push_back('\n');
+    }
+    template<auto Sep, typename First>
+    void format(std::string& buf, const First& first) {
+        buf.reserve(buf.size() + sizeBound(first) + 1);
+        append(buf, first);
+        buf.push_back('\n');
+    }
+}
+
+template<auto Sep = ' ', typename First, typename... Args>
+void fastPrint(const First& first, const Args&... args)
+{
+    auto& pb = fastprint_detail::threadBuffer();
+    fastprint_detail::format<Sep>(pb.data(), first, args...);
+    pb.flush();     // 整行只写一次
+}
+
+template<auto Sep = ' ', typename First, typename... Args>
+void bufferedPrint(const First& first, const Args&... args)
+{
+    auto& pb = fastprint_detail::threadBuffer();
+    fastprint_detail::format<Sep>(pb.data(), first, args...);
+    if (pb.data().size() >= fastprint_detail::PrintBuffer::flushLimit) {
+        pb.flush();
+    }
+}
+
+// 写出当前线程缓冲的输出：
+inline void flushPrintBuffer()
+{
+    fastprint_detail::threadBuffer().flush();
+}
+
+#endif  // FASTPRINT_HPP
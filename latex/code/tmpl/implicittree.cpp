@@ -0,0 +1,124 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <numeric>      // for iota()
+#include <cstdlib>      // for std::atol()
+#include "implicittree.hpp"
+#include "../lib/timer.hpp"
+
+// 和foldtraverse.hpp中的Node相同：
+struct Node {
+    int value;
+    Node *subLeft{nullptr};
+    Node *subRight{nullptr};
+    Node(int i = 0) : value{i} {
+    }
+    int getValue() const {
+        return value;
+    }
+    ~Node() {
+        delete subLeft;
+        delete subRight;
+    }
+    static constexpr auto left = &Node::subLeft;
+    static constexpr auto right = &Node::subRight;
+
+    template<typename T, typename... TP>
+    static Node* traverse(T np, TP... paths) {
+        return (np ->* ... ->* paths);
+    }
+};
+
+// 创建和ImplicitTree形状相同、中序遍历为0, 1, 2, ...的指针树：
+Node* buildNodes(std::size_t idx, std::size_t n, int& next)
+{
+    if (idx >= n) {
+        return nullptr;
+    }
+    Node* left = buildNodes(2 * idx + 1, n, next);
+    Node* np = new Node{next++};
+    np->subLeft = left;
+    np->subRight = buildNodes(2 * idx + 2, n, next);
+    return np;
+}
+
+template<typename Op>
+void inOrder(const Node* np, Op& op)
+{
+    if (np) {
+        inOrder(np->subLeft, op);
+        op(np->value);
+        inOrder(np->subRight, op);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    using Tree = ImplicitTree<int>;
+
+    // 和foldtraverse.cpp相同的遍历：
+    Tree small{std::vector<int>{0, 1, 3, 4, 2}};
+    auto node = Tree::traverse(small.root(), Tree::left, Tree::right);
+    std::cout << node->getValue() << '\n';
+    node = small.root() ->* Tree::left ->* Tree::right;
+    std::cout << node->getValue() << '\n';
+
+    std::size_t n = argc > 1 ? std::atol(argv[1]) : 10'000'000;
+    int depth = 0;
+    while ((std::size_t{4} << depth) - 1 <= n) {    // 最深的完整层
+        ++depth;
+    }
+
+    std::vector<int> sorted(n);
+    std::iota(sorted.begin(), sorted.end(), 0);
+    Timer t;
+    Tree tree = Tree::fromSorted(sorted);
+    t.printDiff("ImplicitTree build:    ");
+    int next = 0;
+    Node* root = buildNodes(0, n, next);
+    t.printDiff("pointer tree build:    ");
+
+    // 深度为depth的随机路径：
+    std::vector<std::uint32_t> paths(1'000'000);
+    std::mt19937 eng{42};
+    for (auto& p : paths) {
+        p = eng();
+    }
+    t.printDiff("generate paths:        ");
+    long long sum1 = 0;
+    for (auto p : paths) {
+        auto np = tree.root();
+        for (int d = 0; d < depth; ++d) {
+            np = np ->* static_cast<bool>((p >> d) & 1);
+        }
+        sum1 += np.getValue();
+    }
+    t.printDiff("ImplicitTree paths:    ");
+    long long sum2 = 0;
+    for (auto p : paths) {
+        Node* np = root;
+        for (int d = 0; d < depth; ++d) {
+            np = np ->* ((p >> d) & 1 ? Node::right : Node::left);
+        }
+        sum2 += np->getValue();
+    }
+    t.printDiff("pointer tree paths:    ");
+    std::cout << "  path sums " << (sum1 == sum2 ? "match" : "DIFFER") << '\n';
+
+    // 完整的中序遍历：
+    long long prev = -1;
+    bool ordered = true;
+    tree.forEachInOrder([&] (int v) {
+                            ordered = ordered && v == prev + 1;
+                            prev = v;
+                        });
+    t.printDiff("ImplicitTree in-order: ");
+    long long sum = 0;
+    auto add = [&] (int v) { sum += v; };
+    inOrder(root, add);
+    t.printDiff("pointer tree in-order: ");
+    std::cout << "  in-order " << (ordered && prev + 1 == static_cast<long long>(n) ? "OK" : "ERROR")
+              << ", sum: " << sum << '\n';
+
+    delete root;
+}
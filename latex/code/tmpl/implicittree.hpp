@@ -0,0 +1,134 @@
+#ifndef IMPLICITTREE_HPP
+#define IMPLICITTREE_HPP
+
+#include <vector>
+#include <cstddef>  // for std::size_t
+#include <utility>  // for std::move()
+
+/********************************************
+* ImplicitTree：用Eytzinger（层序）布局存储的完全二叉树
+* - 下标i的左子节点是2i+1，右子节点是2i+2，不需要存储指针
+* - NodeRef重载了->*，所以和foldtraverse.hpp中一样可以写：
+*     Tree::traverse(root, Tree::left, Tree::right)
+*   编译期已知的路径会被编译为简单的下标运算
+********************************************/
+
+template<typename T>
+class ImplicitTree
+{
+private:
+    std::vector<T> values;  // 按层序存储
+
+    // 把有序的输入按中序填入层序数组：
+    template<typename It>
+    void fillInOrder(It& pos, std::size_t idx) {
+        if (idx < values.size()) {
+            fillInOrder(pos, 2 * idx + 1);
+            values[idx] = *pos++;
+            fillInOrder(pos, 2 * idx + 2);
+        }
+    }
+public:
+    // 代替成员指针Node::subLeft和Node::subRight的标签类型：
+    struct Left {
+    };
+    struct Right {
+    };
+    static constexpr Left left{};
+    static constexpr Right right{};
+
+    // 类似于Node*的轻量句柄：
+    class NodeRef {
+    private:
+        const ImplicitTree* tree = nullptr;
+        std::size_t idx = 0;
+    public:
+        NodeRef() = default;
+        NodeRef(const ImplicitTree* t, std::size_t i) : tree{t}, idx{i} {
+        }
+        friend NodeRef operator->* (NodeRef n, Left) {
+            return {n.tree, 2 * n.idx + 1};
+        }
+        friend NodeRef operator->* (NodeRef n, Right) {
+            return {n.tree, 2 * n.idx + 2};
+        }
+        // 运行期的方向：false是左，true是右
+        friend NodeRef operator->* (NodeRef n, bool toRight) {
+            return {n.tree, 2 * n.idx + 1 + toRight};
+        }
+        const NodeRef* operator-> () const {  // 支持node->getValue()
+            return this;
+        }
+        const T& getValue() const {
+            return tree->values[idx];
+        }
+        std::size_t index() const {
+            return idx;
+        }
+        // 是否指向一个存在的节点（相当于Node*不为nullptr）：
+        explicit operator bool() const {
+            return tree != nullptr && idx < tree->values.size();
+        }
+    };
+
+    ImplicitTree() = default;
+    // 直接用层序的值初始化：
+    explicit ImplicitTree(std::vector<T> levelOrder) : values{std::move(levelOrder)} {
+    }
+    // 用有序的值初始化，使得中序遍历得到相同的顺序：
+    static ImplicitTree fromSorted(const std::vector<T>& sorted) {
+        ImplicitTree t;
+        t.values.resize(sorted.size());
+        auto pos = sorted.begin();
+        t.fillInOrder(pos, 0);
+        return t;
+    }
+
+    std::size_t size() const {
+        return values.size();
+    }
+    NodeRef root() const {
+        return {this, 0};
+    }
+
+    // 和foldtraverse.hpp中相同的折叠表达式：
+    template<typename NP, typename... TP>
+    static NP traverse(NP np, TP... paths) {
+        return (np ->* ... ->* paths);  // np ->* paths1 ->* paths2
+    }
+
+    // 不需要栈的中序遍历，对每个值调用op：
+    template<typename Op>
+    void forEachInOrder(Op op) const {
+        std::size_t n = values.size();
+        if (n == 0) {
+            return;
+        }
+        std::size_t i = 0;
+        while (2 * i + 1 < n) {     // 最左边的节点
+            i = 2 * i + 1;
+        }
+        for (;;) {
+            op(values[i]);
+            if (2 * i + 2 < n) {
+                // 有右子树：进入右子树最左边的节点
+                i = 2 * i + 2;
+                while (2 * i + 1 < n) {
+                    i = 2 * i + 1;
+                }
+            }
+            else {
+                // 向上回溯，直到从某个节点的左子树返回：
+                while (i != 0 && i % 2 == 0) {
+                    i = (i - 1) / 2;
+                }
+                if (i == 0) {
+                    return;
+                }
+                i = (i - 1) / 2;
+            }
+        }
+    }
+};
+
+#endif  // IMPLICITTREE_HPP
@@ -0,0 +1,123 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <chrono>
+#include <cstdlib>      // for std::atoi()
+#include "classarglambda.hpp"
+#include "instrumentcalls.hpp"
+
+template<typename F>
+void measure(const char* name, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> diff{std::chrono::steady_clock::now() - start};
+    std::cout << name << diff.count() << "ms\n";
+}
+
+// 一个开销较大的纯函数：用二叉树模型计算期权价格
+double price(int strike, int days)
+{
+    const double spot = 100, vol = 0.2, rate = 0.01;
+    const int steps = 200;
+    double dt = days / 365.0 / steps;
+    double up = std::exp(vol * std::sqrt(dt));
+    double p = (std::exp(rate * dt) - 1 / up) / (up - 1 / up);
+    std::vector<double> v(steps + 1);
+    for (int i = 0; i <= steps; ++i) {
+        v[i] = std::max(spot * std::pow(up, 2 * i - steps) - strike, 0.0);
+    }
+    for (int s = steps; s > 0; --s) {
+        for (int i = 0; i < s; ++i) {
+            v[i] = (p * v[i + 1] + (1 - p) * v[i]) * std::exp(-rate * dt);
+        }
+    }
+    return v[0];
+}
+
+int main(int argc, char* argv[])
+{
+    int num = argc > 1 ? std::atoi(argv[1]) : 1'000'000;
+
+    std::vector<int> coll(num);
+    std::mt19937 eng{42};
+    std::uniform_int_distribution<int> dist{0, num};
+    for (auto& elem : coll) {
+        elem = dist(eng);
+    }
+
+    // 排序准则的开销：
+    auto less = [] (int x, int y) { return x < y; };
+    measure("sort() plain:            ", [&, v = coll] () mutable {
+        std::sort(v.begin(), v.end(), less);
+    });
+    CountCalls cc{less};
+    measure("sort() CountCalls:       ", [&, v = coll] () mutable {
+        std::sort(v.begin(), v.end(), std::ref(cc));
+    });
+    ProfileCalls pc{less};
+    measure("sort() ProfileCalls:     ", [&, v = coll] () mutable {
+        std::sort(v.begin(), v.end(), pc);  // 不需要std::ref()
+    });
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    ProfileCalls<decltype(less), TscTicks> tc{less};
+    measure("sort() ProfileCalls/TSC: ", [&, v = coll] () mutable {
+        std::sort(v.begin(), v.end(), tc);
+    });
+    tc.print(std::cout, "comparator (rdtsc)");
+#endif
+    std::cout << "CountCalls: " << cc.count() << " calls\n";
+    pc.print(std::cout, "comparator");
+
+    // 多个线程调用同一个包装后的回调，计数不会丢失：
+    ProfileCalls shared{[] (int i) { return i * 2; }};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([shared, num] () mutable {
+            for (int i = 0; i < num / 4; ++i) {
+                shared(i);
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::cout << "4 threads: " << shared.count() << " calls (expected "
+              << num / 4 * 4 << ")\n";
+
+    // 缓存重复出现的定价请求：
+    int requests = num / 10;
+    std::vector<std::pair<int, int>> quotes(requests);
+    std::uniform_int_distribution<int> strikes{80, 120}, days{1, 50};
+    for (auto& [s, d] : quotes) {
+        s = strikes(eng);
+        d = days(eng);
+    }
+    double sum1 = 0, sum2 = 0;
+    ProfileCalls slow{&price};
+    measure("price() uncached: ", [&] {
+        for (auto [s, d] : quotes) {
+            sum1 += slow(s, d);
+        }
+    });
+    auto cached = memoize<int, int>(&price, 4096);
+    measure("price() memoized: ", [&] {
+        for (auto [s, d] : quotes) {
+            sum2 += cached(s, d);
+        }
+    });
+    std::cout << "sums: " << sum1 << ' ' << sum2
+              << (sum1 == sum2 ? " (equal)\n" : " (ERROR)\n");
+    slow.print(std::cout, "price()");
+    cached.print(std::cout, "price() cache");
+
+    // 容量小于不同参数的数量时LRU淘汰最久未使用的结果：
+    auto small = memoize<int, int>(&price, 100);
+    for (auto [s, d] : quotes) {
+        small(s, d);
+    }
+    small.print(std::cout, "price() small cache");
+}
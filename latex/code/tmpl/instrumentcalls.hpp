@@ -0,0 +1,256 @@
+#ifndef INSTRUMENTCALLS_HPP
+#define INSTRUMENTCALLS_HPP
+
+#include <atomic>
+#include <mutex>
+#include <memory>           // for std::shared_ptr
+#include <list>
+#include <unordered_map>
+#include <tuple>
+#include <functional>       // for std::hash, std::invoke()
+#include <utility>          // for std::forward(), std::move()
+#include <type_traits>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>      // for __rdtsc()
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>         // for __rdtsc()
+#endif
+
+/********************************************
+* 在classarglambda.hpp中的CountCalls<>的基础上：
+* - ProfileCalls<CB>：线程安全的调用计数和每次调用耗时的直方图
+*   （以2的幂为分界的桶，时钟为steady_clock或者rdtsc）
+* - memoize<Args...>(cb, capacity)：为纯函数添加有容量上限的LRU缓存，
+*   以参数的哈希值为键，并统计命中和未命中的次数
+* 和CountCalls<>不同，拷贝之间共享同一份统计数据，
+* 所以不再需要用std::ref()把它传给std::sort()
+********************************************/
+
+// 时钟：steady_clock（单位为纳秒）
+struct SteadyTicks {
+    static constexpr const char* unit = "ns";
+    static std::uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+// 时钟：时间戳计数器（单位为周期，开销更小，但不同CPU之间可能不同步）
+struct TscTicks {
+    static constexpr const char* unit = "cycles";
+    static std::uint64_t now() {
+        return __rdtsc();
+    }
+};
+#endif
+
+class CallStats
+{
+public:
+    static constexpr int numBuckets = 64;   // 第i个桶记录[2^i, 2^(i+1))的耗时
+private:
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> ticks{0};
+    std::atomic<std::uint64_t> maxTicks{0};
+    std::atomic<std::uint64_t> buckets[numBuckets]{};
+
+    static int bucketOf(std::uint64_t t) {
+        if (t == 0) {
+            return 0;
+        }
+#ifdef _MSC_VER
+        unsigned long idx;
+        _BitScanReverse64(&idx, t);
+        return static_cast<int>(idx);
+#else
+        return 63 - __builtin_clzll(t);
+#endif
+    }
+public:
+    void record(std::uint64_t t) {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        ticks.fetch_add(t, std::memory_order_relaxed);
+        buckets[bucketOf(t)].fetch_add(1, std::memory_order_relaxed);
+        auto old = maxTicks.load(std::memory_order_relaxed);
+        while (t > old && !maxTicks.compare_exchange_weak(old, t, std::memory_order_relaxed)) {
+        }
+    }
+    std::uint64_t count() const {
+        return calls.load(std::memory_order_relaxed);
+    }
+    std::uint64_t totalTicks() const {
+        return ticks.load(std::memory_order_relaxed);
+    }
+    std::uint64_t max() const {
+        return maxTicks.load(std::memory_order_relaxed);
+    }
+    std::uint64_t bucket(int i) const {
+        return buckets[i].load(std::memory_order_relaxed);
+    }
+    // 百分位数的上界（所在的桶的上界）：
+    std::uint64_t percentile(double p) const {
+        auto total = count();
+        std::uint64_t seen = 0;
+        for (int i = 0; i < numBuckets; ++i) {
+            seen += bucket(i);
+            if (seen > 0 && seen >= p / 100 * total) {
+                return i == 63 ? max() : (std::uint64_t{2} << i) - 1;
+            }
+        }
+        return max();
+    }
+    void print(std::ostream& os, std::string_view name, const char* unit) const {
+        auto n = count();
+        os << name << ": " << n << " calls";
+        if (n == 0) {
+            os << '\n';
+            return;
+        }
+        os << ", avg " << totalTicks() / n << unit
+           << ", p50 <= " << percentile(50) << unit
+           << ", p99 <= " << percentile(99) << unit
+           << ", max " << max() << unit << '\n';
+        for (int i = 0; i < numBuckets; ++i) {
+            if (auto b = bucket(i); b > 0) {
+                os << "  [" << (std::uint64_t{1} << i) << ", "
+                   << (i == 63 ? max() : (std::uint64_t{2} << i) - 1) << "]: " << b << '\n';
+            }
+        }
+    }
+};
+
+template<typename CB, typename Ticks = SteadyTicks>
+class ProfileCalls
+{
+private:
+    CB callback;    // 要调用的回调函数
+    std::shared_ptr<CallStats> stats = std::make_shared<CallStats>();
+
+    // 在析构函数中记录耗时，这样void返回值和异常都能被正确处理：
+    struct Timing {
+        CallStats& stats;
+        std::uint64_t start = Ticks::now();
+        ~Timing() {
+            stats.record(Ticks::now() - start);
+        }
+    };
+public:
+    ProfileCalls(CB cb) : callback(std::move(cb)) {
+    }
+    template<typename... Args>
+    decltype(auto) operator() (Args&&... args) {
+        Timing t{*stats};
+        return callback(std::forward<Args>(args)...);
+    }
+    long count() const {
+        return static_cast<long>(stats->count());
+    }
+    const CallStats& statistics() const {
+        return *stats;
+    }
+    void print(std::ostream& os, std::string_view name) const {
+        stats->print(os, name, Ticks::unit);
+    }
+};
+
+// 组合所有参数的哈希值：
+struct HashArgs {
+    template<typename... Args>
+    std::size_t operator() (const std::tuple<Args...>& args) const {
+        return std::apply([] (const auto&... a) {
+                              std::size_t seed = 0;
+                              (... , (seed ^= std::hash<std::decay_t<decltype(a)>>{}(a)
+                                              + 0x9e3779b9 + (seed << 6) + (seed >> 2)));
+                              return seed;
+                          }, args);
+    }
+};
+
+template<typename CB, typename Result, typename... Args>
+class MemoCalls
+{
+private:
+    using Key = std::tuple<Args...>;
+    using Lru = std::list<std::pair<Key, Result>>;  // 最近使用的在前面
+
+    struct Cache {
+        std::mutex mx;
+        Lru lru;
+        std::unordered_map<Key, typename Lru::iterator, HashArgs> index;
+        std::size_t capacity;
+        std::atomic<std::uint64_t> hits{0};
+        std::atomic<std::uint64_t> misses{0};
+    };
+
+    CB callback;
+    std::shared_ptr<Cache> cache = std::make_shared<Cache>();
+public:
+    MemoCalls(CB cb, std::size_t capacity) : callback(std::move(cb)) {
+        cache->capacity = capacity > 0 ? capacity : 1;
+    }
+
+    Result operator() (const Args&... args) {
+        Key key{args...};
+        {
+            std::lock_guard lg{cache->mx};
+            if (auto pos = cache->index.find(key); pos != cache->index.end()) {
+                cache->lru.splice(cache->lru.begin(), cache->lru, pos->second);
+                cache->hits.fetch_add(1, std::memory_order_relaxed);
+                return pos->second->second;
+            }
+        }
+        cache->misses.fetch_add(1, std::memory_order_relaxed);
+        // 计算时不持有锁（其他线程可能同时计算相同的值，结果是相同的）：
+        Result result = std::invoke(callback, args...);
+        std::lock_guard lg{cache->mx};
+        if (cache->index.find(key) == cache->index.end()) {
+            cache->lru.emplace_front(std::move(key), result);
+            cache->index.emplace(cache->lru.front().first, cache->lru.begin());
+            if (cache->lru.size() > cache->capacity) {
+                cache->index.erase(cache->lru.back().first);
+                cache->lru.pop_back();
+            }
+        }
+        return result;
+    }
+
+    std::uint64_t hits() const {
+        return cache->hits.load(std::memory_order_relaxed);
+    }
+    std::uint64_t misses() const {
+        return cache->misses.load(std::memory_order_relaxed);
+    }
+    std::size_t size() const {
+        std::lock_guard lg{cache->mx};
+        return cache->lru.size();
+    }
+    void clear() {
+        std::lock_guard lg{cache->mx};
+        cache->index.clear();
+        cache->lru.clear();
+    }
+    void print(std::ostream& os, std::string_view name) const {
+        auto h = hits();
+        auto m = misses();
+        os << name << ": " << h << " hits, " << m << " misses";
+        if (h + m > 0) {
+            os << " (" << 100.0 * h / (h + m) << "% hit rate)";
+        }
+        os << ", " << size() << " cached\n";
+    }
+};
+
+// 参数类型必须显式指定，例如：memoize<double, int>(price, 1000)
+template<typename... Args, typename CB>
+auto memoize(CB cb, std::size_t capacity)
+{
+    using Result = std::decay_t<std::invoke_result_t<CB&, const std::decay_t<Args>&...>>;
+    return MemoCalls<CB, Result, std::decay_t<Args>...>{std::move(cb), capacity};
+}
+
+#endif  // INSTRUMENTCALLS_HPP
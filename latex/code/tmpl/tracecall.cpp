@@ -0,0 +1,107 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <type_traits>
+#include <cstdlib>      // for std::atoi()
+#include "tracecall.hpp"
+
+// 返回值类型必须和std::invoke()完全相同：
+int value(int i) { return i; }
+int& lref(int& i) { return i; }
+int&& rref(int& i) { return std::move(i); }
+void nothing() {}
+
+static_assert(std::is_same_v<decltype(tracedCall("v", value, 1)), int>);
+static_assert(std::is_same_v<decltype(tracedCall("l", lref, std::declval<int&>())), int&>);
+static_assert(std::is_same_v<decltype(tracedCall("r", rref, std::declval<int&>())), int&&>);
+static_assert(std::is_same_v<decltype(tracedCall("n", nothing)), void>);
+
+std::string words(int n)
+{
+    return std::string(n, 'x');
+}
+
+// 每次调用的开销（纳秒）：
+template<bool Enabled>
+double nsPerCall(int num)
+{
+    unsigned x = 0;     // 无符号，不会溢出
+    auto inc = [&x] (int i) { x += i; };
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num; ++i) {
+        tracedCall<Enabled>("inc", inc, i);
+        if constexpr (Enabled) {
+            if (i % trace::ThreadBuffer::capacity == 0) {
+                trace::Registry::instance().clear();    // 不测量丢弃事件的路径
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> d{std::chrono::steady_clock::now() - start};
+    volatile unsigned sink = x;
+    (void)sink;
+    return d.count() / num;
+}
+
+int main(int argc, char* argv[])
+{
+    int num = argc > 1 ? std::atoi(argv[1]) : 100'000'000;
+
+    int i = 42;
+    tracedCall("lref", lref, i) = 7;    // 返回的引用指向i
+    std::cout << "i: " << i << '\n';
+    std::cout << "size: " << tracedCall("words", words, 5).size() << '\n';
+
+    double off = nsPerCall<false>(num);
+    double on = nsPerCall<true>(num);
+    std::cout << "disabled: " << off << " ns per call\n";
+    std::cout << "enabled:  " << on << " ns per call\n";
+    std::cout << "overhead: " << on - off << " ns per call"
+              << (on - off < 5 ? " (< 5ns)\n" : " (>= 5ns)\n");
+
+    // 每次调用需要读两次时间戳，在虚拟机中读时间戳计数器可能非常慢：
+    std::uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int j = 0; j < num; ++j) {
+        sum += trace::now();
+    }
+    std::chrono::duration<double, std::nano> d{std::chrono::steady_clock::now() - start};
+    volatile std::uint64_t sink = sum;
+    (void)sink;
+    std::cout << "one timestamp: " << d.count() / num << " ns\n";
+
+    // 多个线程的事件导出为一个trace：
+    trace::Registry::instance().clear();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([t] {
+            for (int j = 0; j < 5; ++j) {
+                tracedCall("outer", [=] {
+                    tracedCall("sleep", [] {
+                        std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    });
+                    return words(t + j);
+                });
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    // 依次创建的线程复用之前的线程的缓冲区：
+    auto before = trace::Registry::instance().bufferCount();
+    for (int t = 0; t < 100; ++t) {
+        std::thread{[] { tracedCall("short", nothing); }}.join();
+    }
+    std::cout << "100 threads one after another: "
+              << trace::Registry::instance().bufferCount() - before << " new buffers\n";
+
+    tracedCall("tab\there", nothing);     // 导出为"tab\u0009here"
+    std::ofstream out{"trace.json"};
+    trace::writeChromeTrace(out);
+    std::cout << "trace.json written, " << trace::Registry::instance().dropped()
+              << " events dropped\n";
+}
@@ -0,0 +1,259 @@
+#ifndef TRACECALL_HPP
+#define TRACECALL_HPP
+
+#include <atomic>
+#include <mutex>
+#include <memory>       // for std::unique_ptr
+#include <vector>
+#include <functional>   // for std::invoke()
+#include <utility>      // for std::forward(), std::pair
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#include <ostream>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>  // for __rdtsc()
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>     // for __rdtsc()
+#endif
+
+/********************************************
+* tracedCall(name, op, args...)：和invoke.hpp以及perfectreturn.hpp中的call()相同，
+* 但是在调用前后记录时间戳，写入当前线程的缓冲区：
+* - 记录一次调用只需要读两次时间戳计数器并写入当前线程的缓冲区（不需要锁和原子操作）
+* - 缓冲区满了之后丢弃新的事件并计数
+* - 线程结束后它的缓冲区（连同已经记录的事件）被之后新建的线程复用，
+*   所以内存只取决于同时存在的线程数，而不是创建过的线程总数
+* - writeChromeTrace()把所有线程的事件导出为Chrome的trace event JSON格式
+*   （可以用chrome://tracing或者Perfetto打开）
+* 编译时定义TRACECALL_ENABLED=0后tracedCall()和直接调用std::invoke()完全相同
+* 返回值通过一个在析构函数中记录的对象处理，
+* 所以void、引用和值类型的返回值都和std::invoke()完全相同
+* 注意：name只被拷贝指针，所以应该使用字符串字面量
+********************************************/
+
+#ifndef TRACECALL_ENABLED
+#define TRACECALL_ENABLED 1
+#endif
+
+#ifndef TRACECALL_BUFFER_SIZE
+#define TRACECALL_BUFFER_SIZE (1 << 16)     // 每个线程最多记录的事件数
+#endif
+
+namespace trace {
+
+    inline constexpr bool enabled = TRACECALL_ENABLED;
+
+    // 时间戳：x86上使用时间戳计数器，否则使用steady_clock的纳秒数
+    inline std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    struct Event {
+        const char* name;
+        std::uint64_t begin;
+        std::uint64_t end;
+    };
+
+    struct ThreadBuffer {
+        static constexpr std::size_t capacity = TRACECALL_BUFFER_SIZE;
+        std::unique_ptr<Event[]> events{new Event[capacity]};
+        std::atomic<std::size_t> size{0};       // 只被所属线程修改
+        std::atomic<std::uint64_t> dropped{0};  // 只被所属线程修改，但是可能被其他线程读取
+        // 复用的缓冲区中依次存放多个线程的事件，每段记录（第一个事件的下标，tid），
+        // 只在持有Registry的锁时访问：
+        std::vector<std::pair<std::size_t, unsigned>> segments;
+
+        void record(const char* name, std::uint64_t begin, std::uint64_t end) {
+            auto n = size.load(std::memory_order_relaxed);
+            if (n == capacity) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            events[n] = Event{name, begin, end};
+            size.store(n + 1, std::memory_order_release);
+        }
+    };
+
+    class Registry {
+    private:
+        std::mutex mx;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;    // 线程结束后仍然保留
+        std::vector<ThreadBuffer*> freeBuffers;                // 已经结束的线程的缓冲区
+        unsigned nextTid = 1;
+        // 用于把时间戳换算成微秒：
+        std::uint64_t startTicks = now();
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+        Registry() = default;
+    public:
+        static Registry& instance() {
+            static Registry reg;
+            return reg;
+        }
+
+        // 为新线程分配缓冲区，优先复用已经结束的线程的缓冲区：
+        ThreadBuffer* add() {
+            {
+                std::lock_guard lg{mx};
+                if (!freeBuffers.empty()) {
+                    ThreadBuffer* buf = freeBuffers.back();
+                    freeBuffers.pop_back();
+                    auto n = buf->size.load(std::memory_order_relaxed);
+                    if (buf->segments.back().first == n) {
+                        buf->segments.pop_back();   // 之前的线程没有留下事件
+                    }
+                    buf->segments.emplace_back(n, nextTid++);
+                    return buf;
+                }
+            }
+            auto fresh = std::make_unique<ThreadBuffer>();  // 在锁外分配
+            std::lock_guard lg{mx};
+            fresh->segments.emplace_back(0, nextTid++);
+            buffers.push_back(std::move(fresh));
+            return buffers.back().get();
+        }
+
+        // 线程结束时调用，之后的线程可以继续使用这个缓冲区：
+        void release(ThreadBuffer* buf) {
+            std::lock_guard lg{mx};
+            freeBuffers.push_back(buf);
+        }
+
+        // 每微秒的时间戳数：
+        double ticksPerMicrosecond() {
+            auto ticks = now() - startTicks;
+            std::chrono::duration<double, std::micro> us{
+                std::chrono::steady_clock::now() - startTime};
+            return us.count() > 0 ? ticks / us.count() : 1000.0;
+        }
+
+        // 分配过的缓冲区数（等于同时存在的线程数的最大值）：
+        std::size_t bufferCount() {
+            std::lock_guard lg{mx};
+            return buffers.size();
+        }
+
+        std::uint64_t dropped() {
+            std::lock_guard lg{mx};
+            std::uint64_t sum = 0;
+            for (auto& b : buffers) {
+                sum += b->dropped.load(std::memory_order_relaxed);
+            }
+            return sum;
+        }
+
+        // 只应该在被导出的线程不再记录事件时调用：
+        void clear() {
+            std::lock_guard lg{mx};
+            for (auto& b : buffers) {
+                b->size.store(0, std::memory_order_relaxed);
+                b->dropped.store(0, std::memory_order_relaxed);
+                b->segments.erase(b->segments.begin(), b->segments.end() - 1);
+                b->segments.front().first = 0;  // 只保留当前（或者最后一个）线程
+            }
+        }
+
+        // 转义JSON字符串中的引号、反斜杠和控制字符：
+        static void writeJsonString(std::ostream& os, const char* s) {
+            for (const char* p = s; *p; ++p) {
+                auto c = static_cast<unsigned char>(*p);
+                if (c == '"' || c == '\\') {
+                    os << '\\' << *p;
+                }
+                else if (c < 0x20) {
+                    static const char hex[] = "0123456789abcdef";
+                    os << "\\u00" << hex[c >> 4] << hex[c & 0xf];
+                }
+                else {
+                    os << *p;
+                }
+            }
+        }
+
+        void writeChromeTrace(std::ostream& os) {
+            double perUs = ticksPerMicrosecond();
+            std::lock_guard lg{mx};
+            os << "{\"traceEvents\":[";
+            const char* sep = "\n";
+            for (auto& b : buffers) {
+                auto n = b->size.load(std::memory_order_acquire);
+                std::size_t seg = 0;
+                for (std::size_t i = 0; i < n; ++i) {
+                    while (seg + 1 < b->segments.size() && b->segments[seg + 1].first <= i) {
+                        ++seg;
+                    }
+                    const Event& e = b->events[i];
+                    os << sep << "{\"name\":\"";
+                    writeJsonString(os, e.name);
+                    os << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << b->segments[seg].second
+                       << ",\"ts\":" << (e.begin - startTicks) / perUs
+                       << ",\"dur\":" << (e.end - e.begin) / perUs << '}';
+                    sep = ",\n";
+                }
+            }
+            os << "\n]}\n";
+        }
+    };
+
+    // 线程结束时把缓冲区交还给Registry：
+    class BufferOwner {
+    private:
+        ThreadBuffer* buf = Registry::instance().add();
+    public:
+        ~BufferOwner() {
+            Registry::instance().release(buf);
+        }
+        ThreadBuffer& get() {
+            return *buf;
+        }
+    };
+
+    inline ThreadBuffer& threadBuffer() {
+        thread_local BufferOwner owner;
+        return owner.get();
+    }
+
+    // 在构造和析构时记录时间戳：
+    template<bool Enabled = enabled>
+    class Scope {
+    private:
+        const char* name;
+        std::uint64_t begin;
+    public:
+        explicit Scope(const char* n) : name{n}, begin{now()} {
+        }
+        ~Scope() {
+            auto end = now();
+            threadBuffer().record(name, begin, end);
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator= (const Scope&) = delete;
+    };
+
+    template<>
+    class Scope<false> {
+    public:
+        explicit Scope(const char*) {
+        }
+    };
+
+    inline void writeChromeTrace(std::ostream& os) {
+        Registry::instance().writeChromeTrace(os);
+    }
+}
+
+template<bool Enabled = trace::enabled, typename Callable, typename... Args>
+decltype(auto) tracedCall(const char* name, Callable&& op, Args&&... args)
+{
+    trace::Scope<Enabled> scope{name};              // 在返回值构造之后记录结束时间
+    return std::invoke(std::forward<Callable>(op),
+                       std::forward<Args>(args)...);
+}
+
+#endif  // TRACECALL_HPP
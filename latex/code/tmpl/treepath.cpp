@@ -0,0 +1,95 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <cstdlib>      // for std::atoi()
+#include "treepath.hpp"
+#include "../lib/timer.hpp"
+
+// 和foldtraverse.hpp中的Node相同：
+struct Node {
+    int value;
+    Node *subLeft{nullptr};
+    Node *subRight{nullptr};
+    Node(int i = 0) : value{i} {
+    }
+    int getValue() const {
+        return value;
+    }
+    ~Node() {
+        delete subLeft;
+        delete subRight;
+    }
+    static constexpr auto left = &Node::subLeft;
+    static constexpr auto right = &Node::subRight;
+
+    template<typename T, typename... TP>
+    static Node* traverse(T np, TP... paths) {
+        return (np ->* ... ->* paths);
+    }
+};
+
+// 深度为depth的完全二叉树，值为层序的下标：
+Node* buildNodes(int idx, int depth)
+{
+    Node* np = new Node{idx};
+    if (depth > 0) {
+        np->subLeft = buildNodes(2 * idx + 1, depth - 1);
+        np->subRight = buildNodes(2 * idx + 2, depth - 1);
+    }
+    return np;
+}
+
+int main(int argc, char* argv[])
+{
+    // 编译期的路径：
+    using LR = TreePath<Node::left, Node::right>;
+    static_assert(LR::value.length == 2 && !LR::value.step(0) && LR::value.step(1));
+
+    Node* root = buildNodes(0, 3);
+    std::cout << Node::traverse(root, Node::left, Node::right)->getValue() << '\n';
+    std::cout << LR::apply(root)->getValue() << '\n';
+    std::cout << evalPath(root, LR::value)->getValue() << '\n';
+    ImplicitTree<int> itree{std::vector<int>{0, 1, 2, 3, 4, 5, 6}};
+    std::cout << evalPath(itree, LR::value).getValue() << '\n';
+    delete root;
+
+    // 决策树：每个请求查询相同的numPaths个固定路径
+    int depth = argc > 1 ? std::atoi(argv[1]) : 22;
+    int numPaths = 4096;
+    int numRequests = 1000;
+    root = buildNodes(0, depth);
+    std::vector<PathBits> paths;
+    std::mt19937_64 eng{42};
+    for (int i = 0; i < numPaths; ++i) {
+        PathBits p;
+        // 很多路径共享较短的前缀：
+        auto prefix = eng() % 64;
+        for (int d = 0; d < depth; ++d) {
+            p = p.then(d < 6 ? (prefix >> d) & 1 : eng() & 1);
+        }
+        paths.push_back(p);
+    }
+
+    Timer t;
+    long long sum1 = 0;
+    for (int r = 0; r < numRequests; ++r) {
+        for (const auto& p : paths) {
+            sum1 += evalPath(root, p)->getValue();
+        }
+    }
+    t.printDiff("one path at a time:  ");
+
+    PathBatch<Node> batch{paths};
+    std::vector<Node*> result;
+    t.printDiff("PathBatch setup:     ");
+    long long sum2 = 0;
+    for (int r = 0; r < numRequests; ++r) {
+        batch.eval(root, result);
+        for (Node* np : result) {
+            sum2 += np->getValue();
+        }
+    }
+    t.printDiff("PathBatch::eval():   ");
+    std::cout << "sums " << (sum1 == sum2 ? "match" : "DIFFER") << '\n';
+    delete root;
+}
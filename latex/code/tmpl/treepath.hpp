@@ -0,0 +1,164 @@
+#ifndef TREEPATH_HPP
+#define TREEPATH_HPP
+
+#include <vector>
+#include <cstdint>
+#include <numeric>      // for iota()
+#include <algorithm>    // for sort(), min()
+#include <type_traits>  // for std::common_type_t
+#include <cassert>
+#include "implicittree.hpp"
+#ifdef _MSC_VER
+#include <intrin.h>     // for __lzcnt64(), _mm_prefetch()
+#endif
+
+/********************************************
+* 编译期的树路径：
+* - TreePath<Node::left, Node::right, ...>::value在编译期把
+*   一串left/right编码为一个位串PathBits
+* - PathBatch对大量路径排序，共享相同的前缀，
+*   并在向下遍历时预取下一层的节点
+* - 对于ImplicitTree，一个路径可以直接被计算为一个下标
+********************************************/
+
+// 第i步存储在第63-i位（1表示向右），所以整数的顺序就是路径的字典序
+// 路径最多有63步（ImplicitTree的下标需要计算2^length）：
+struct PathBits {
+    static constexpr unsigned maxLength = 63;
+    std::uint64_t bits = 0;
+    unsigned length = 0;
+
+    constexpr PathBits then(bool toRight) const {
+        assert(length < maxLength);     // 否则63-length会溢出
+        return {bits | (std::uint64_t{toRight} << (63 - length)), length + 1};
+    }
+    constexpr bool step(unsigned i) const {
+        return (bits >> (63 - i)) & 1;
+    }
+    friend constexpr bool operator< (const PathBits& a, const PathBits& b) {
+        return a.bits < b.bits || (a.bits == b.bits && a.length < b.length);
+    }
+};
+
+namespace treepath_detail {
+    template<typename M>
+    struct ClassOf;
+    template<typename C, typename T>
+    struct ClassOf<T C::*> {
+        using type = C;
+    };
+
+    inline unsigned countlZero(std::uint64_t x) {
+        if (x == 0) {
+            return 64;
+        }
+#ifdef _MSC_VER
+        return static_cast<unsigned>(__lzcnt64(x));     // Windows API
+#else
+        return static_cast<unsigned>(__builtin_clzll(x));
+#endif
+    }
+
+    inline void prefetch(const void* p) {
+#ifdef _MSC_VER
+        _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+        __builtin_prefetch(p);
+#endif
+    }
+}
+
+// 编译期的路径：成员指针必须是节点类型的left或right
+template<auto... Members>
+struct TreePath {
+    using NodeT = typename treepath_detail::ClassOf<
+                      std::common_type_t<decltype(Members)...>>::type;
+    static_assert(sizeof...(Members) <= PathBits::maxLength, "paths are limited to 63 steps");
+private:
+    static constexpr PathBits make() {
+        PathBits p{};
+        ((p = p.then(Members == NodeT::right)), ...);
+        return p;
+    }
+public:
+    static constexpr PathBits value = make();
+
+    // 和Node::traverse()一样直接计算：
+    template<typename NP>
+    static NP apply(NP np) {
+        return (np ->* ... ->* Members);
+    }
+};
+
+// 在运行期沿着路径遍历指针树：
+template<typename NodeT>
+NodeT* evalPath(NodeT* np, PathBits p)
+{
+    for (unsigned i = 0; i < p.length && np != nullptr; ++i) {
+        np = np ->* (p.step(i) ? NodeT::right : NodeT::left);
+    }
+    return np;
+}
+
+// 对ImplicitTree来说路径就是一个下标：第L层从2^L-1开始
+template<typename T>
+typename ImplicitTree<T>::NodeRef evalPath(const ImplicitTree<T>& tree, PathBits p)
+{
+    assert(p.length <= PathBits::maxLength);    // 否则1<<length是未定义行为
+    std::size_t offset = p.length == 0 ? 0 : p.bits >> (64 - p.length);
+    return {&tree, ((std::size_t{1} << p.length) - 1) + offset};
+}
+
+// 对同一组路径反复求值：
+// 路径只排序一次，之后每次求值时共享相同的前缀
+template<typename NodeT>
+class PathBatch
+{
+private:
+    std::vector<PathBits> sorted;
+    std::vector<std::size_t> order;     // sorted[i]原来的位置
+    std::vector<unsigned> shared;       // 和前一个路径共同前缀的长度
+public:
+    explicit PathBatch(const std::vector<PathBits>& paths) {
+        order.resize(paths.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&] (std::size_t a, std::size_t b) {
+                      return paths[a] < paths[b];
+                  });
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const PathBits& p = paths[order[i]];
+            unsigned common = 0;
+            if (i > 0) {
+                const PathBits& prev = sorted.back();
+                common = std::min({treepath_detail::countlZero(prev.bits ^ p.bits),
+                                   prev.length, p.length});
+            }
+            sorted.push_back(p);
+            shared.push_back(common);
+        }
+    }
+
+    // 对每个路径求值，结果按照原来的顺序存入result：
+    void eval(NodeT* root, std::vector<NodeT*>& result) const {
+        result.resize(sorted.size());
+        std::vector<NodeT*> stack{root};    // stack[d]是当前路径上第d层的节点
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            const PathBits& p = sorted[i];
+            stack.resize(shared[i] + 1);
+            NodeT* np = stack.back();
+            for (unsigned d = shared[i]; d < p.length && np != nullptr; ++d) {
+                np = np ->* (p.step(d) ? NodeT::right : NodeT::left);
+                if (np != nullptr) {
+                    // 在使用当前节点时预取下一层的两个子节点：
+                    treepath_detail::prefetch(np ->* NodeT::left);
+                    treepath_detail::prefetch(np ->* NodeT::right);
+                }
+                stack.push_back(np);
+            }
+            result[order[i]] = np;
+        }
+    }
+};
+
+#endif  // TREEPATH_HPP